@@ -0,0 +1,9 @@
+#version 330 core
+
+out vec4 FragColor;
+
+void main()
+{
+    // Only the depth test matters, color writes are masked while bounds are drawn
+    FragColor = vec4(1.0);
+}
\ No newline at end of file
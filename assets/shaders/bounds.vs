@@ -0,0 +1,17 @@
+#version 330 core
+
+layout(location = 0) in vec3 aPosition;
+
+layout(std140) uniform Matrices {
+    mat4 view;
+    mat4 projection;
+};
+
+layout(std140) uniform Object {
+    mat4 model;
+};
+
+void main()
+{
+    gl_Position = projection * view * model * vec4(aPosition, 1.0);
+}
\ No newline at end of file
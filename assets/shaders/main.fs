@@ -1,6 +1,7 @@
 #version 330 core
 
 in vec2 TexCoord;
+flat in vec4 Tile;
 
 uniform sampler2D texture1;
 
@@ -8,5 +9,6 @@ out vec4 FragColor;
 
 void main()
 {
-    FragColor = texture(texture1, TexCoord);
+    // Texture coordinates are in tiles, wrap them inside the tile bounds so merged quads repeat their tile
+    FragColor = texture(texture1, mix(Tile.xy, Tile.zw, fract(TexCoord)));
 }
\ No newline at end of file
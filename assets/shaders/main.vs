@@ -1,18 +1,35 @@
 #version 330 core
 
-layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec2 aTexCoord;
+// x: position (x 0-4, y 5-13, z 14-18), y: tile (0-15) and texture coordinates (u 16-20, v 21-25)
+layout(location = 0) in uvec2 aPacked;
 
 out vec2 TexCoord;
+flat out vec4 Tile;
 
 layout(std140) uniform Matrices {
-    mat4 model;
     mat4 view;
     mat4 projection;
 };
 
+uniform int tilesPerRow;
+uniform float pixelSize;
+
+// Chunk positions, one per page of the chunk vertex pool
+uniform samplerBuffer origins;
+uniform int poolPageSize;
+
 void main()
 {
-    TexCoord = aTexCoord;
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    vec3 position = vec3(aPacked.x & 31u, (aPacked.x >> 5) & 511u, (aPacked.x >> 14) & 31u);
+
+    uint tile = aPacked.y & 0xFFFFu;
+    float tileSize = 1.0 / float(tilesPerRow);
+    vec2 tileMin = vec2(float(tile % uint(tilesPerRow)), float(tile / uint(tilesPerRow))) * tileSize + pixelSize;
+    vec2 tileMax = tileMin + tileSize - 2.0 * pixelSize;
+
+    TexCoord = vec2((aPacked.y >> 16) & 31u, (aPacked.y >> 21) & 31u);
+    Tile = vec4(tileMin, tileMax);
+    // gl_VertexID includes the base vertex, so it is the vertex's index in the whole pool
+    vec3 origin = texelFetch(origins, gl_VertexID / poolPageSize).xyz;
+    gl_Position = projection * view * vec4(origin + position, 1.0);
 }
\ No newline at end of file
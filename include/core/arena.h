@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ARENA_ALIGNMENT 16
+
+/**
+ * Linear scratch allocator.
+ *
+ * Memory is handed out from a single block allocated up front and released all at once with `arena_reset`, so hot
+ * paths reusing an arena never go through the system allocator.
+ */
+typedef struct {
+    uint8_t *data;
+    size_t capacity;
+    size_t offset;
+
+    // Statistics, kept across resets
+    size_t peak;
+    size_t allocated;
+    size_t allocation_count;
+} arena_t;
+
+/**
+ * @brief Initializes an arena and allocates its memory.
+ *
+ * @param arena The arena to initialize.
+ * @param capacity The number of bytes the arena can hand out between resets.
+ *
+ * @return int Zero if the arena was initialized successfully, non-zero otherwise.
+ */
+int arena_init(arena_t *arena, size_t capacity);
+
+/**
+ * @brief Releases the memory owned by the arena.
+ *
+ * @param arena The arena to free.
+ */
+void arena_free(arena_t *arena);
+
+/**
+ * @brief Allocates memory from the arena, aligned to `ARENA_ALIGNMENT` bytes.
+ *
+ * @param arena The arena to allocate from.
+ * @param size The number of bytes to allocate.
+ *
+ * @return void* The allocated memory, or NULL if the arena is out of space.
+ */
+void *arena_alloc(arena_t *arena, size_t size);
+
+/**
+ * @brief Releases every allocation made from the arena since the last reset.
+ *
+ * @param arena The arena to reset.
+ */
+void arena_reset(arena_t *arena);
@@ -0,0 +1,123 @@
+#pragma once
+
+/**
+ * @brief A job run by a worker thread, or by the main thread while it waits or services main thread jobs.
+ *
+ * @param arg The argument the job was submitted with.
+ * @param worker The index of the thread running the job, in `[0, job_system_get_worker_count())`. Lets jobs use
+ * per-thread data without locking.
+ */
+typedef void (*job_function_t)(void *arg, int worker);
+
+/**
+ * Workers drain higher priority lanes first, from their own deque and then by stealing from the other workers.
+ */
+typedef enum {
+    JOB_PRIORITY_HIGH   = 0,
+    JOB_PRIORITY_NORMAL = 1,
+    JOB_PRIORITY_LOW    = 2,
+    JOB_PRIORITY_COUNT,
+} job_priority_t;
+
+/**
+ * Number of unfinished jobs submitted with the counter. Incremented on submission and decremented once the job
+ * function returns, so a job submitting a continuation with the same counter keeps it above zero. Must be zero
+ * initialized.
+ */
+typedef struct {
+    int value;
+} job_counter_t;
+
+typedef struct {
+    job_function_t function;
+    void *arg;
+    job_priority_t priority;
+
+    // Optional, may be NULL
+    job_counter_t *counter;
+} job_t;
+
+typedef struct {
+    // Number of worker threads, zero uses `job_system_default_thread_count`
+    int thread_count;
+} job_system_settings_t;
+
+/**
+ * @brief Initializes the job system and starts its workers. Must be called on the main thread.
+ *
+ * @param settings The settings to use for the job system.
+ *
+ * @return int Zero if the job system was initialized successfully, non-zero otherwise.
+ */
+int job_system_init(job_system_settings_t settings);
+
+/**
+ * @brief Runs every remaining job to completion and stops the workers. Must be called on the main thread.
+ */
+void job_system_deinit();
+
+/**
+ * @brief Queues a job for the workers. Can be called from any thread.
+ *
+ * Jobs submitted by a worker go to its own deque, where it picks them up last in first out. Jobs submitted by other
+ * threads are spread over the workers.
+ *
+ * @param job The job to queue.
+ *
+ * @return int Zero if the job was queued, non-zero otherwise.
+ */
+int job_system_submit(const job_t *job);
+
+/**
+ * @brief Queues a job for the main thread. Can be called from any thread.
+ *
+ * Main thread jobs run in submission order from `job_system_run_main_thread_jobs`, the priority is ignored. Use them
+ * for work that needs the GL context or must not race with the main thread, like finishing a background job.
+ *
+ * @param job The job to queue.
+ *
+ * @return int Zero if the job was queued, non-zero otherwise.
+ */
+int job_system_submit_main_thread(const job_t *job);
+
+/**
+ * @brief Runs the main thread jobs queued so far. Must be called on the main thread, once per frame.
+ *
+ * Jobs queued while running are left for the next call.
+ *
+ * @return int The number of jobs run.
+ */
+int job_system_run_main_thread_jobs();
+
+/**
+ * @brief Blocks until every job submitted with the counter has finished.
+ *
+ * The calling thread runs queued jobs while waiting, the main thread also runs main thread jobs. Workers must not
+ * wait on counters of main thread jobs.
+ *
+ * @param counter The counter to wait for.
+ */
+void job_system_wait(job_counter_t *counter);
+
+/**
+ * @brief Retrieves the number of unfinished jobs submitted with the counter.
+ *
+ * @param counter The counter.
+ *
+ * @return int The number of unfinished jobs.
+ */
+int job_counter_get(const job_counter_t *counter);
+
+/**
+ * @brief Returns the number of threads that may run jobs, the workers plus the main thread.
+ *
+ * @return int The number of worker indices passed to jobs.
+ */
+int job_system_get_worker_count();
+
+/**
+ * @brief Returns the default number of worker threads, one per online CPU except the one running the main thread.
+ *
+ * @return int The default number of worker threads, at least one.
+ */
+int job_system_default_thread_count();
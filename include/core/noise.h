@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stdint.h>
+
+// Side length of the planes and sections evaluated by the batched noise functions, matches the chunk size
+#define NOISE_GRID_SIZE 16
+
+typedef enum {
+    NOISE_KERNEL_SCALAR = 0,
+    NOISE_KERNEL_SSE2   = 1,
+    NOISE_KERNEL_AVX2   = 2,
+} noise_kernel_t;
+
+/**
+ * Fractal Brownian motion parameters. Every octave samples the noise at `lacunarity` times the frequency and `gain`
+ * times the amplitude of the previous one, the sum is normalized back to roughly [-1, 1].
+ */
+typedef struct {
+    uint32_t seed;
+    int octaves;
+    float frequency;
+    float lacunarity;
+    float gain;
+} noise_fbm_t;
+
+/**
+ * @brief Retrieves the kernel used by the batched noise functions.
+ *
+ * Defaults to the widest kernel the CPU supports.
+ *
+ * @return noise_kernel_t The active kernel.
+ */
+noise_kernel_t noise_get_kernel();
+
+/**
+ * @brief Selects the kernel used by the batched noise functions.
+ *
+ * Kernels the CPU does not support fall back to the widest supported one. Every kernel produces the same values as
+ * the scalar reference. Not thread safe, call before noise is evaluated on other threads.
+ *
+ * @param kernel The kernel to use.
+ */
+void noise_set_kernel(noise_kernel_t kernel);
+
+/**
+ * @brief Evaluates seeded 2D gradient noise at a single point. This is the scalar reference for the kernels.
+ *
+ * @param seed The seed of the noise.
+ * @param x The x coordinate.
+ * @param y The y coordinate.
+ *
+ * @return float The noise value, roughly in [-1, 1].
+ */
+float noise_2d(uint32_t seed, float x, float y);
+
+/**
+ * @brief Evaluates seeded 3D gradient noise at a single point. This is the scalar reference for the kernels.
+ *
+ * @param seed The seed of the noise.
+ * @param x The x coordinate.
+ * @param y The y coordinate.
+ * @param z The z coordinate.
+ *
+ * @return float The noise value, roughly in [-1, 1].
+ */
+float noise_3d(uint32_t seed, float x, float y, float z);
+
+/**
+ * @brief Evaluates 2D fractal noise at a single point.
+ *
+ * @param fbm The fractal parameters.
+ * @param x The x coordinate.
+ * @param y The y coordinate.
+ *
+ * @return float The noise value, roughly in [-1, 1].
+ */
+float noise_fbm_2d(const noise_fbm_t *fbm, float x, float y);
+
+/**
+ * @brief Evaluates 3D fractal noise at a single point.
+ *
+ * @param fbm The fractal parameters.
+ * @param x The x coordinate.
+ * @param y The y coordinate.
+ * @param z The z coordinate.
+ *
+ * @return float The noise value, roughly in [-1, 1].
+ */
+float noise_fbm_3d(const noise_fbm_t *fbm, float x, float y, float z);
+
+/**
+ * @brief Evaluates 2D fractal noise over a `NOISE_GRID_SIZE` squared plane of points spaced one unit apart.
+ *
+ * @param fbm The fractal parameters.
+ * @param x The x coordinate of the first point.
+ * @param y The y coordinate of the first point.
+ * @param values The output values, indexed by `x + y * NOISE_GRID_SIZE`.
+ */
+void noise_fbm_2d_plane(const noise_fbm_t *fbm, float x, float y, float *values);
+
+/**
+ * @brief Evaluates 3D fractal noise over a `NOISE_GRID_SIZE` cubed section of points spaced one unit apart.
+ *
+ * @param fbm The fractal parameters.
+ * @param x The x coordinate of the first point.
+ * @param y The y coordinate of the first point.
+ * @param z The z coordinate of the first point.
+ * @param values The output values, indexed by `x + z * NOISE_GRID_SIZE + y * NOISE_GRID_SIZE * NOISE_GRID_SIZE` like
+ * chunk sections.
+ */
+void noise_fbm_3d_section(const noise_fbm_t *fbm, float x, float y, float z, float *values);
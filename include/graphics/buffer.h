@@ -18,9 +18,22 @@ typedef enum {
 typedef enum {
     BUFFER_TARGET_ARRAY_BUFFER = 0x8892,
     BUFFER_TARGET_ELEMENT_ARRAY_BUFFER = 0x8893,
-    BUFFER_TARGET_UNIFORM_BUFFER = 0x8A11
+    BUFFER_TARGET_UNIFORM_BUFFER = 0x8A11,
+    BUFFER_TARGET_TEXTURE_BUFFER = 0x8C2A,
+    BUFFER_TARGET_COPY_READ_BUFFER = 0x8F36,
+    BUFFER_TARGET_COPY_WRITE_BUFFER = 0x8F37
 } buffer_target_t;
 
+// Flags of `buffer_map_range`, combined with a bitwise or
+typedef enum {
+    BUFFER_ACCESS_READ              = 0x0001,
+    BUFFER_ACCESS_WRITE             = 0x0002,
+    BUFFER_ACCESS_INVALIDATE_RANGE  = 0x0004,
+    BUFFER_ACCESS_INVALIDATE_BUFFER = 0x0008,
+    BUFFER_ACCESS_FLUSH_EXPLICIT    = 0x0010,
+    BUFFER_ACCESS_UNSYNCHRONIZED    = 0x0020
+} buffer_access_t;
+
 /**
  * @brief Creates a buffer with the specified size and data.
  *
@@ -53,9 +66,11 @@ void buffer_bind(uint32_t buffer, buffer_target_t target);
  * @param buffer The ID of the buffer to bind.
  * @param target The target to which the buffer is bound.
  * @param binding_point The binding point within the target.
+ * @param offset The offset of the range within the buffer, a multiple of the target's offset alignment.
  * @param size The size of the range to bind.
  */
-void buffer_bind_range(uint32_t buffer, buffer_target_t target, const uint32_t binding_point, size_t size);
+void buffer_bind_range(uint32_t buffer, buffer_target_t target, const uint32_t binding_point, size_t offset,
+                       size_t size);
 
 /**
  * @brief Binds the base of the specified buffer to the given target.
@@ -92,3 +107,41 @@ void buffer_data(uint32_t buffer, buffer_target_t target, size_t size, const voi
  * @param data A pointer to the data to update the buffer with.
  */
 void buffer_sub_data(uint32_t buffer, buffer_target_t target, size_t offset, size_t size, const void *data);
+
+/**
+ * @brief Copies a range of one buffer into another on the GPU.
+ *
+ * Source and destination may be the same buffer as long as the ranges do not overlap.
+ *
+ * @param source The ID of the buffer to copy from.
+ * @param destination The ID of the buffer to copy to.
+ * @param source_offset The offset within the source buffer to start copying from.
+ * @param destination_offset The offset within the destination buffer to start copying to.
+ * @param size The size of the data to copy.
+ */
+void buffer_copy_sub_data(uint32_t source, uint32_t destination, size_t source_offset, size_t destination_offset,
+                          size_t size);
+
+/**
+ * @brief Maps a range of the specified buffer into client memory.
+ *
+ * With `BUFFER_ACCESS_UNSYNCHRONIZED` the driver does not wait for commands still using the buffer, the caller must
+ * make sure none of them touches the range, e.g. with a fence.
+ *
+ * @param buffer The ID of the buffer to map.
+ * @param target The target the buffer is bound to while mapping.
+ * @param offset The offset of the range within the buffer.
+ * @param size The size of the range to map.
+ * @param access The `buffer_access_t` flags of the mapping.
+ * @return A pointer to the mapped range, or NULL if it could not be mapped.
+ */
+void *buffer_map_range(uint32_t buffer, buffer_target_t target, size_t offset, size_t size, uint32_t access);
+
+/**
+ * @brief Unmaps the mapped range of the specified buffer. The pointer returned by `buffer_map_range` becomes invalid.
+ *
+ * @param buffer The ID of the buffer to unmap.
+ * @param target The target the buffer is bound to while unmapping.
+ * @return Zero if the buffer was unmapped successfully, non-zero if its contents were lost and must be written again.
+ */
+int buffer_unmap(uint32_t buffer, buffer_target_t target);
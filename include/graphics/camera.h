@@ -5,6 +5,7 @@
 #include <cglm/cglm.h>
 #include <cglm/struct.h>
 
+#include "graphics/frustum.h"
 #include "graphics/shader_program.h"
 
 typedef struct camera camera_t;
@@ -138,3 +139,29 @@ vec3s camera_get_up(camera_t *camera);
  * @return vec3s The right vector of the camera.
  */
 vec3s camera_get_right(camera_t *camera);
+
+/**
+ * @brief Sets the projection matrix of the camera.
+ * 
+ * @param camera The camera to set the projection of.
+ * @param projection The new projection matrix.
+ */
+void camera_set_projection(camera_t *camera, mat4s projection);
+
+/**
+ * @brief Gets the projection matrix of the camera.
+ * 
+ * @param camera The camera to get the projection of.
+ * 
+ * @return mat4s The projection matrix of the camera.
+ */
+mat4s camera_get_projection(camera_t *camera);
+
+/**
+ * @brief Gets the world space frustum of the camera's current view and projection.
+ * 
+ * @param camera The camera to get the frustum of.
+ * 
+ * @return frustum_t The frustum planes of the camera.
+ */
+frustum_t camera_get_frustum(camera_t *camera);
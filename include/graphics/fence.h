@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * A point in the GL command stream, signaled once the GPU finished every command issued before it. NULL is never a
+ * valid fence.
+ */
+typedef void *fence_t;
+
+/**
+ * @brief Inserts a fence after the commands issued so far.
+ *
+ * @return fence_t The created fence, or NULL if it could not be created.
+ */
+fence_t fence_create();
+
+/**
+ * @brief Destroys the specified fence and sets it to NULL.
+ *
+ * @param fence A pointer to the fence to destroy.
+ */
+void fence_destroy(fence_t *fence);
+
+/**
+ * @brief Checks if the fence was signaled, without waiting for the GPU.
+ *
+ * @param fence The fence to check.
+ *
+ * @return int Non-zero if the fence was signaled.
+ */
+int fence_signaled(fence_t fence);
+
+/**
+ * @brief Waits until the fence is signaled, flushing the commands before it if needed.
+ *
+ * @param fence The fence to wait for.
+ * @param timeout The maximum time to wait, in nanoseconds.
+ *
+ * @return int Zero if the fence was signaled, non-zero if the wait timed out or failed.
+ */
+int fence_wait(fence_t fence, uint64_t timeout);
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cglm/struct.h>
+
+enum frustum_plane {
+    FRUSTUM_PLANE_LEFT,
+    FRUSTUM_PLANE_RIGHT,
+    FRUSTUM_PLANE_BOTTOM,
+    FRUSTUM_PLANE_TOP,
+    FRUSTUM_PLANE_NEAR,
+    FRUSTUM_PLANE_FAR,
+    FRUSTUM_PLANE_COUNT,
+};
+
+/**
+ * Clip planes of a view-projection matrix in world space, indexed by `enum frustum_plane`. Every plane is stored as
+ * `(normal, distance)` with a unit normal pointing inside, so points inside the frustum have a positive distance to all
+ * of them.
+ */
+typedef struct {
+    vec4s planes[FRUSTUM_PLANE_COUNT];
+} frustum_t;
+
+/**
+ * Axis aligned boxes stored as a structure of arrays, so testing a whole batch against a plane streams through
+ * contiguous floats and vectorizes.
+ */
+typedef struct {
+    float *min_x;
+    float *min_y;
+    float *min_z;
+    float *max_x;
+    float *max_y;
+    float *max_z;
+
+    // Result of the last frustum test, one entry per box
+    uint8_t *visible;
+
+    size_t count;
+    size_t capacity;
+} aabb_list_t;
+
+/**
+ * @brief Extracts the frustum planes of a view-projection matrix.
+ *
+ * @param view_projection The matrix transforming world space into clip space.
+ *
+ * @return frustum_t The frustum of the matrix.
+ */
+frustum_t frustum_from_matrix(mat4s view_projection);
+
+/**
+ * @brief Tests every box of the list against the frustum and stores the results in `boxes->visible`.
+ *
+ * Boxes are conservatively kept: a box is only culled if it lies entirely behind one of the planes.
+ *
+ * @param frustum The frustum to test against.
+ * @param boxes The boxes to test.
+ */
+void frustum_cull_aabbs(const frustum_t *frustum, aabb_list_t *boxes);
+
+/**
+ * @brief Initializes an empty box list.
+ *
+ * @param boxes The list to initialize.
+ * @param capacity The number of boxes to reserve room for.
+ *
+ * @return int Zero if the list was initialized successfully, non-zero otherwise.
+ */
+int aabb_list_init(aabb_list_t *boxes, size_t capacity);
+
+/**
+ * @brief Releases the memory owned by the box list.
+ *
+ * @param boxes The list to free.
+ */
+void aabb_list_free(aabb_list_t *boxes);
+
+/**
+ * @brief Appends a box to the list, growing it if needed.
+ *
+ * @param boxes The list to append to.
+ * @param min The minimum corner of the box.
+ * @param max The maximum corner of the box.
+ *
+ * @return int Zero if the box was appended, non-zero otherwise.
+ */
+int aabb_list_push(aabb_list_t *boxes, vec3s min, vec3s max);
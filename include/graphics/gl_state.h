@@ -0,0 +1,116 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Thin layer in front of the GL binding calls that remembers what is bound and skips calls that would not change
+ * anything. Every bind in the graphics module goes through it, so the cached state stays in sync with the context.
+ * Must only be used on the thread owning the GL context.
+ */
+
+// GL calls issued and skipped as redundant
+typedef struct {
+    uint64_t issued;
+    uint64_t skipped;
+} gl_state_counters_t;
+
+/**
+ * @brief Makes the specified program current.
+ *
+ * @param program The ID of the program, zero for none.
+ */
+void gl_state_use_program(uint32_t program);
+
+/**
+ * @brief Binds the specified vertex array.
+ *
+ * @param vertex_array The ID of the vertex array, zero to unbind.
+ */
+void gl_state_bind_vertex_array(uint32_t vertex_array);
+
+/**
+ * @brief Binds a buffer to a target.
+ *
+ * The element array buffer binding belongs to the bound vertex array, it is only cached until another vertex array is
+ * bound.
+ *
+ * @param target The GL buffer target.
+ * @param buffer The ID of the buffer, zero to unbind.
+ */
+void gl_state_bind_buffer(uint32_t target, uint32_t buffer);
+
+/**
+ * @brief Binds a range of a buffer to an indexed binding point of a target.
+ *
+ * @param target The GL buffer target.
+ * @param index The binding point.
+ * @param buffer The ID of the buffer.
+ * @param offset The offset of the range.
+ * @param size The size of the range, zero to bind the whole buffer.
+ */
+void gl_state_bind_buffer_range(uint32_t target, uint32_t index, uint32_t buffer, size_t offset, size_t size);
+
+/**
+ * @brief Selects the texture unit following texture binds apply to.
+ *
+ * @param slot The index of the texture unit.
+ */
+void gl_state_active_texture(uint32_t slot);
+
+/**
+ * @brief Binds a texture to a target of the active texture unit.
+ *
+ * @param target The GL texture target.
+ * @param texture The ID of the texture, zero to unbind.
+ */
+void gl_state_bind_texture(uint32_t target, uint32_t texture);
+
+/**
+ * @brief Assigns a uniform buffer binding point to a uniform block of a program.
+ *
+ * @param program The ID of the program.
+ * @param block_index The index of the uniform block in the program.
+ * @param binding_point The binding point the block reads from.
+ */
+void gl_state_uniform_block_binding(uint32_t program, uint32_t block_index, uint32_t binding_point);
+
+/**
+ * @brief Drops a deleted program from the cache, must be called when deleting it.
+ *
+ * @param program The ID of the program.
+ */
+void gl_state_forget_program(uint32_t program);
+
+/**
+ * @brief Drops a deleted vertex array from the cache, must be called when deleting it.
+ *
+ * @param vertex_array The ID of the vertex array.
+ */
+void gl_state_forget_vertex_array(uint32_t vertex_array);
+
+/**
+ * @brief Drops a deleted buffer from the cache, must be called when deleting it.
+ *
+ * @param buffer The ID of the buffer.
+ */
+void gl_state_forget_buffer(uint32_t buffer);
+
+/**
+ * @brief Drops a deleted texture from the cache, must be called when deleting it.
+ *
+ * @param texture The ID of the texture.
+ */
+void gl_state_forget_texture(uint32_t texture);
+
+/**
+ * @brief Returns the number of calls issued and skipped since the counters were last reset.
+ *
+ * @return gl_state_counters_t The counters.
+ */
+gl_state_counters_t gl_state_get_counters();
+
+/**
+ * @brief Resets the counters to zero.
+ */
+void gl_state_reset_counters();
@@ -6,7 +6,7 @@
 #include "graphics/shader_program.h"
 
 #define MESH_EMPTY_INIT do {\
-    mesh_create(NULL, 0, NULL, 0, NULL, -1);\
+    mesh_create(NULL, NULL, 0, NULL, 0, NULL, -1);\
     } while(0)
 
 typedef struct mesh_private_data mesh_private_data_t;
@@ -23,6 +23,7 @@ typedef struct {
  * 
  * This function creates a new mesh object with the specified vertices, indices, shader program, and texture.
  * 
+ * @param layout The layout of the vertices, or NULL for `vertex_t` vertices.
  * @param vertices An array of vertices.
  * @param vertex_count The number of vertices in the array.
  * @param indices An array of indices.
@@ -32,7 +33,7 @@ typedef struct {
  * 
  * @return mesh_t* A pointer to the newly created mesh object.
  */
-mesh_t *mesh_create(vertex_t *vertices, size_t vertex_count, 
+mesh_t *mesh_create(const vertex_layout_t *layout, const void *vertices, size_t vertex_count, 
     uint32_t *indices, size_t index_count, 
     shader_program_t *shader_program, uint32_t texture);
 
@@ -51,10 +52,10 @@ void mesh_destroy(mesh_t *mesh);
  * This function sets the vertices of the specified mesh object.
  * 
  * @param mesh A pointer to the mesh object.
- * @param vertices An array of vertices.
+ * @param vertices An array of vertices matching the layout of the mesh.
  * @param vertex_count The number of vertices in the array.
  */
-void mesh_set_vertices(mesh_t *mesh, vertex_t *vertices, size_t vertex_count);
+void mesh_set_vertices(mesh_t *mesh, const void *vertices, size_t vertex_count);
 
 /**
  * @brief Sets the indices of the specified mesh.
@@ -67,6 +68,48 @@ void mesh_set_vertices(mesh_t *mesh, vertex_t *vertices, size_t vertex_count);
  */
 void mesh_set_indices(mesh_t *mesh, uint32_t *indices, size_t index_count);
 
+/**
+ * @brief Overwrites a range of the vertices of the specified mesh in place.
+ * 
+ * The range must lie within the vertices last set on the mesh. Only that part of the vertex buffer is uploaded.
+ * 
+ * @param mesh A pointer to the mesh object.
+ * @param offset The index of the first vertex to overwrite.
+ * @param vertices An array of vertices matching the layout of the mesh.
+ * @param vertex_count The number of vertices in the array.
+ */
+void mesh_update_vertices(mesh_t *mesh, size_t offset, const void *vertices, size_t vertex_count);
+
+/**
+ * @brief Sets the vertices of the specified quad mesh.
+ * 
+ * Quad meshes have no index data of their own. Every four vertices form a quad drawn through a shared index buffer
+ * owned by the mesh module, which grows as needed. Setting indices afterwards turns the mesh back into a regular one.
+ * 
+ * @param mesh A pointer to the mesh object.
+ * @param vertices An array of vertices matching the layout of the mesh, four per quad.
+ * @param vertex_count The number of vertices in the array.
+ */
+void mesh_set_quads(mesh_t *mesh, const void *vertices, size_t vertex_count);
+
+/**
+ * @brief Grows the shared quad index buffer to cover at least the given number of quads.
+ * 
+ * The buffer keeps its ID when it grows, so vertex arrays referencing it stay valid.
+ * 
+ * @param quad_count The number of quads the buffer must cover.
+ * 
+ * @return uint32_t The ID of the shared quad index buffer, or zero if it could not be grown.
+ */
+uint32_t mesh_quad_indices_reserve(size_t quad_count);
+
+/**
+ * @brief Destroys the shared quad index buffer.
+ * 
+ * Must be called before the GL context is destroyed.
+ */
+void mesh_quad_indices_destroy();
+
 /**
  * @brief Binds the specified mesh for rendering.
  * 
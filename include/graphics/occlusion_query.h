@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Creates an occlusion query object.
+ *
+ * @return The ID of the created query.
+ */
+uint32_t occlusion_query_create();
+
+/**
+ * @brief Destroys the specified occlusion query.
+ *
+ * @param query A pointer to the ID of the query to destroy.
+ */
+void occlusion_query_destroy(uint32_t *query);
+
+/**
+ * @brief Starts counting whether any sample passes the depth test, until `occlusion_query_end` is called.
+ *
+ * Starting a query discards the result of its previous run.
+ *
+ * @param query The ID of the query to start.
+ */
+void occlusion_query_begin(uint32_t query);
+
+/**
+ * @brief Ends the running occlusion query.
+ */
+void occlusion_query_end();
+
+/**
+ * @brief Checks if the result of the last run of the query arrived, without waiting for the GPU.
+ *
+ * @param query The ID of the query.
+ *
+ * @return int Non-zero if the result is available.
+ */
+int occlusion_query_available(uint32_t query);
+
+/**
+ * @brief Reads the result of the last run of the query. Blocks until the GPU finished it if it is not available yet.
+ *
+ * @param query The ID of the query.
+ *
+ * @return int Non-zero if any sample passed the depth test.
+ */
+int occlusion_query_passed(uint32_t query);
+
+/**
+ * @brief Discards the draws issued until `occlusion_query_end_conditional` if no sample passed the query.
+ *
+ * The GPU waits for the query itself, the CPU never stalls.
+ *
+ * @param query The ID of the query the draws depend on.
+ */
+void occlusion_query_begin_conditional(uint32_t query);
+
+/**
+ * @brief Ends conditional rendering.
+ */
+void occlusion_query_end_conditional();
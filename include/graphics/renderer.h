@@ -4,9 +4,29 @@
 
 #include "graphics/mesh.h"
 #include "graphics/camera.h"
+#include "graphics/gl_state.h"
+#include "graphics/vertex_pool.h"
 
 #define RENDERER_DEFAULT_CLEAR_COLOR (vec3s){{0.0f, 0.0f, 0.0f}}
 
+// Consecutive indices of a mesh or of a vertex pool range, counted in indices
+typedef struct {
+    size_t first;
+    size_t count;
+} renderer_index_range_t;
+
+/**
+ * Draws collected for a single multi-draw call, as the arrays `glMultiDrawElementsBaseVertex` takes. `offsets` are
+ * byte offsets into the index buffer.
+ */
+typedef struct {
+    int *counts;
+    const void **offsets;
+    int *base_vertices;
+    size_t count;
+    size_t capacity;
+} renderer_draw_batch_t;
+
 typedef struct {
     vec3s clear_color;
     float near_clip;
@@ -17,6 +37,9 @@ typedef struct {
 typedef struct {
     int wireframe;
 
+    // Skip drawing chunks hidden behind others according to GPU occlusion queries
+    int occlusion_queries;
+
     vec3s clear_color;
 
     camera_t *camera;
@@ -25,6 +48,9 @@ typedef struct {
     float far_clip;
 
     float max_anisotropy;
+
+    // GL binding calls issued and skipped during the last frame
+    gl_state_counters_t gl_state_counters;
 } renderer_state_t;
 
 /**
@@ -69,6 +95,58 @@ void renderer_end_frame();
  */
 void renderer_draw_mesh(mesh_t *mesh, vec3s position, vec3s rotation, vec3s scale);
 
+/**
+ * @brief Disables color and depth writes and face culling, so meshes drawn until `renderer_end_occlusion_pass` only
+ * feed occlusion queries.
+ */
+void renderer_begin_occlusion_pass();
+
+/**
+ * @brief Restores the state changed by `renderer_begin_occlusion_pass`.
+ */
+void renderer_end_occlusion_pass();
+
+/**
+ * @brief Initializes an empty draw batch.
+ * 
+ * @param batch The batch to initialize.
+ * @param capacity The number of draws to allocate room for, zero for a default.
+ * 
+ * @return int Zero if the batch was initialized successfully, non-zero otherwise.
+ */
+int renderer_draw_batch_init(renderer_draw_batch_t *batch, size_t capacity);
+
+/**
+ * @brief Releases the arrays of a draw batch.
+ * 
+ * @param batch The batch to free.
+ */
+void renderer_draw_batch_free(renderer_draw_batch_t *batch);
+
+/**
+ * @brief Appends a draw to a batch, growing it as needed.
+ * 
+ * @param batch The batch to append to.
+ * @param range The indices to draw.
+ * @param base_vertex The value added to every index, e.g. the first vertex of a vertex pool range.
+ * 
+ * @return int Zero if the draw was appended successfully, non-zero otherwise.
+ */
+int renderer_draw_batch_push(renderer_draw_batch_t *batch, renderer_index_range_t range, size_t base_vertex);
+
+/**
+ * @brief Draws every draw of a batch from a vertex pool in a single call, then empties the batch.
+ * 
+ * The vertices are placed by the origins of their pool ranges, the model matrix is left untouched.
+ * 
+ * @param pool The pool holding the vertices.
+ * @param shader_program The shader program to draw with.
+ * @param texture The texture to draw with.
+ * @param batch The draws to issue.
+ */
+void renderer_draw_pool_batch(vertex_pool_t *pool, shader_program_t *shader_program, uint32_t texture,
+                              renderer_draw_batch_t *batch);
+
 /**
  * @brief Returns the uniform buffer used by the renderer.
  * 
@@ -59,3 +59,21 @@ uint32_t shader_program_get_uniform_block_index(shader_program_t *program, const
  * @param binding_point The binding point to bind the uniform block to.
  */
 void shader_program_bind_uniform_block(shader_program_t *program, const char *name, uint32_t binding_point);
+
+/**
+ * @brief Sets an integer uniform of the given shader program.
+ * 
+ * @param program Pointer to the shader program.
+ * @param name The name of the uniform.
+ * @param value The value to set.
+ */
+void shader_program_set_int(shader_program_t *program, const char *name, int value);
+
+/**
+ * @brief Sets a float uniform of the given shader program.
+ * 
+ * @param program Pointer to the shader program.
+ * @param name The name of the uniform.
+ * @param value The value to set.
+ */
+void shader_program_set_float(shader_program_t *program, const char *name, float value);
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Frames whose uploads may be in flight at once, each one writes its own part of the ring
+#define STAGING_RING_FRAMES 3
+
+/**
+ * A staging buffer split into one part per frame in flight. Data is written into the current frame's part through an
+ * unsynchronized mapping and copied into its destination buffer on the GPU, so uploads never wait for draws reading
+ * the destination. The size of a part caps the bytes a frame can upload.
+ *
+ * A fence per part tells when the GPU is done copying out of it. If it is not by the time the part comes around again,
+ * the whole buffer is orphaned instead of waiting, the driver keeps the old storage alive for the pending copies.
+ */
+typedef struct staging_ring staging_ring_t;
+
+/**
+ * @brief Creates a new staging ring.
+ *
+ * @param frame_capacity The number of bytes each frame can upload.
+ *
+ * @return staging_ring_t* The created ring, or NULL if it could not be created.
+ */
+staging_ring_t *staging_ring_create(size_t frame_capacity);
+
+/**
+ * @brief Destroys the specified staging ring.
+ *
+ * @param ring The ring to destroy.
+ */
+void staging_ring_destroy(staging_ring_t *ring);
+
+/**
+ * @brief Moves on to the next part of the ring, orphaning the buffer if the GPU still copies out of that part.
+ *
+ * @param ring The ring.
+ */
+void staging_ring_begin_frame(staging_ring_t *ring);
+
+/**
+ * @brief Fences the copies issued out of the part written this frame.
+ *
+ * @param ring The ring.
+ */
+void staging_ring_end_frame(staging_ring_t *ring);
+
+/**
+ * @brief Writes data into the current frame's part and copies it into a range of another buffer.
+ *
+ * @param ring The ring to stage the data in.
+ * @param destination The ID of the buffer to copy the data to.
+ * @param destination_offset The offset within the destination buffer.
+ * @param data The data to upload.
+ * @param size The size of the data.
+ *
+ * @return int Zero if the data was staged and copied, non-zero if it does not fit the rest of this frame's part or the
+ * ring could not be written.
+ */
+int staging_ring_upload(staging_ring_t *ring, uint32_t destination, size_t destination_offset, const void *data,
+                        size_t size);
+
+/**
+ * @brief Returns the number of bytes the current frame can still upload.
+ *
+ * @param ring The ring.
+ *
+ * @return size_t The bytes left in the current frame's part.
+ */
+size_t staging_ring_get_available(staging_ring_t *ring);
+
+/**
+ * @brief Returns the number of bytes a frame can upload.
+ *
+ * @param ring The ring.
+ *
+ * @return size_t The size of a frame's part.
+ */
+size_t staging_ring_get_capacity(staging_ring_t *ring);
@@ -97,6 +97,25 @@ void texture_generate_mipmaps(uint32_t texture);
  */
 void texture_set_anisotropy(uint32_t texture, float anisotropy);
 
+/**
+ * @brief Makes a texture read the specified buffer as an array of `vec4` texels.
+ * 
+ * The texture becomes a buffer texture, sampled with `samplerBuffer` and `texelFetch` in GLSL. It has to be attached
+ * again whenever the buffer's data store is recreated.
+ * 
+ * @param texture The ID of the texture.
+ * @param buffer The ID of the buffer holding 32-bit float RGBA texels.
+ */
+void texture_set_buffer(uint32_t texture, uint32_t buffer);
+
+/**
+ * @brief Binds a buffer texture to a specified slot.
+ * 
+ * @param texture The ID of the buffer texture to bind.
+ * @param slot The slot to bind the texture to.
+ */
+void texture_bind_buffer(uint32_t texture, uint32_t slot);
+
 /**
  * @brief Destroys a texture.
  * 
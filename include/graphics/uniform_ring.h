@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Frames whose uniforms may be in flight at once, each one writes its own part of the ring
+#define UNIFORM_RING_FRAMES 3
+
+/**
+ * A uniform buffer split into one part per frame in flight. Uniforms of every draw are appended to the current
+ * frame's part and bound as a range of it, so no draw ever overwrites data an earlier draw still reads. A fence per
+ * part keeps a frame from reusing it before the GPU is done with the frame that last wrote it.
+ */
+typedef struct uniform_ring uniform_ring_t;
+
+/**
+ * @brief Creates a new uniform ring.
+ *
+ * @param frame_capacity The number of bytes each frame can append, it grows when a frame runs out.
+ *
+ * @return uniform_ring_t* The created ring, or NULL if it could not be created.
+ */
+uniform_ring_t *uniform_ring_create(size_t frame_capacity);
+
+/**
+ * @brief Destroys the specified uniform ring.
+ *
+ * @param ring The ring to destroy.
+ */
+void uniform_ring_destroy(uniform_ring_t *ring);
+
+/**
+ * @brief Moves on to the next part of the ring, waiting for the GPU if it still reads it.
+ *
+ * @param ring The ring.
+ */
+void uniform_ring_begin_frame(uniform_ring_t *ring);
+
+/**
+ * @brief Fences the part of the ring written this frame.
+ *
+ * @param ring The ring.
+ */
+void uniform_ring_end_frame(uniform_ring_t *ring);
+
+/**
+ * @brief Appends uniform data and binds it to a uniform buffer binding point.
+ *
+ * @param ring The ring to append to.
+ * @param data The data to append, laid out as the std140 block it is bound to.
+ * @param size The size of the data.
+ * @param binding_point The binding point to bind the data to.
+ *
+ * @return int Zero if the data was appended successfully, non-zero otherwise.
+ */
+int uniform_ring_push(uniform_ring_t *ring, const void *data, size_t size, uint32_t binding_point);
@@ -1,8 +1,40 @@
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <cglm/struct.h>
 
+#include "graphics/vertex_array.h"
+
+#define VERTEX_LAYOUT_MAX_ATTRIBUTES 8
+
 typedef struct {
     vec3s position;
     vec2s uv;
 } vertex_t;
+
+/**
+ * Describes a single vertex attribute. Integer attributes are handed to the shader as integers instead of being
+ * converted to floats, so they have to be declared as `int`/`uint` vectors in GLSL.
+ */
+typedef struct {
+    uint32_t index;
+    int size;
+    vertex_array_data_type_t type;
+    int integer;
+    size_t offset;
+} vertex_attribute_t;
+
+typedef struct {
+    size_t stride;
+    size_t attribute_count;
+    vertex_attribute_t attributes[VERTEX_LAYOUT_MAX_ATTRIBUTES];
+} vertex_layout_t;
+
+// Layout of `vertex_t`, used by meshes created without an explicit layout
+#define VERTEX_LAYOUT_DEFAULT_INIT                                                   \
+    {sizeof(vertex_t),                                                               \
+     2,                                                                              \
+     {{0, 3, VERTEX_ARRAY_DATA_TYPE_FLOAT, 0, offsetof(vertex_t, position)},         \
+      {1, 2, VERTEX_ARRAY_DATA_TYPE_FLOAT, 0, offsetof(vertex_t, uv)}}}
@@ -49,3 +49,17 @@ void vertex_array_unbind();
  * @param pointer A pointer to the first component of the first vertex attribute in the array.
  */
 void vertex_array_attrib(uint32_t index, int size, vertex_array_data_type_t type, int stride, const void *pointer);
+
+/**
+ * @brief Specifies the format of an integer vertex attribute.
+ *
+ * Unlike `vertex_array_attrib`, the components are not converted to floats and reach the shader as integers.
+ *
+ * @param index The index of the vertex attribute.
+ * @param size The number of components per vertex attribute.
+ * @param type The integer data type of each component in the array.
+ * @param stride The byte offset between consecutive vertex attributes.
+ * @param pointer A pointer to the first component of the first vertex attribute in the array.
+ */
+void vertex_array_attrib_integer(uint32_t index, int size, vertex_array_data_type_t type, int stride,
+                                 const void *pointer);
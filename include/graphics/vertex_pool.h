@@ -0,0 +1,147 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cglm/struct.h>
+
+#include "graphics/staging_ring.h"
+#include "graphics/vertex.h"
+
+// Ranges are allocated in pages of this many vertices, every page belongs to a single range
+#define VERTEX_POOL_PAGE_SIZE 64
+
+// Texture slot `vertex_pool_bind` binds the origins of the pages to
+#define VERTEX_POOL_ORIGIN_SLOT 1
+
+/**
+ * A single vertex buffer shared by many meshes, each one owning a range of it. Every range is drawn through the same
+ * vertex array, which references the shared quad index buffer, by passing its offset as the base vertex.
+ *
+ * Every range has an origin its vertices are relative to, so ranges at different places can be drawn by a single
+ * call. The origins are stored per page in a buffer texture, a vertex shader reads the origin of its vertex with
+ * `texelFetch(origins, gl_VertexID / VERTEX_POOL_PAGE_SIZE).xyz`. `gl_VertexID` includes the base vertex.
+ */
+typedef struct vertex_pool vertex_pool_t;
+
+/**
+ * A range of vertices inside a pool, owned by the caller. The pool keeps track of it and updates `offset` when
+ * defragmentation moves the vertices, so it must stay at the same address while allocated.
+ */
+typedef struct {
+    vertex_pool_t *pool;
+
+    // First vertex and number of vertices of the range, both whole pages
+    size_t offset;
+    size_t count;
+
+    vec3s origin;
+
+    // Position in the pool's allocation list
+    size_t index;
+} vertex_pool_allocation_t;
+
+/**
+ * @brief Creates a new vertex pool.
+ *
+ * @param layout The layout of the vertices stored in the pool.
+ * @param capacity The initial number of vertices the pool holds, rounded up to whole pages. It grows as needed.
+ *
+ * @return vertex_pool_t* The created pool, or NULL if it could not be created.
+ */
+vertex_pool_t *vertex_pool_create(const vertex_layout_t *layout, size_t capacity);
+
+/**
+ * @brief Destroys the pool. Allocations still alive are detached from it and hold no vertices anymore.
+ *
+ * @param pool The pool to destroy.
+ */
+void vertex_pool_destroy(vertex_pool_t *pool);
+
+/**
+ * @brief Allocates a range of vertices. The vertices are undefined until uploaded and the origin until set.
+ *
+ * @param pool The pool to allocate from.
+ * @param allocation The allocation to initialize, must not be allocated already.
+ * @param count The number of vertices to allocate, rounded up to whole pages.
+ *
+ * @return int Zero if the range was allocated successfully, non-zero otherwise.
+ */
+int vertex_pool_alloc(vertex_pool_t *pool, vertex_pool_allocation_t *allocation, size_t count);
+
+/**
+ * @brief Returns the range of vertices to its pool.
+ *
+ * @param allocation The allocation to free.
+ */
+void vertex_pool_free(vertex_pool_allocation_t *allocation);
+
+/**
+ * @brief Overwrites vertices of an allocated range.
+ *
+ * @param allocation The allocation to write to.
+ * @param offset The index of the first vertex to overwrite, relative to the range.
+ * @param vertices An array of vertices matching the layout of the pool.
+ * @param count The number of vertices in the array.
+ */
+void vertex_pool_upload(vertex_pool_allocation_t *allocation, size_t offset, const void *vertices, size_t count);
+
+/**
+ * @brief Overwrites vertices of an allocated range through a staging ring, the GPU copies them into place.
+ *
+ * @param allocation The allocation to write to.
+ * @param offset The index of the first vertex to overwrite, relative to the range.
+ * @param vertices An array of vertices matching the layout of the pool.
+ * @param count The number of vertices in the array.
+ * @param staging The ring to stage the vertices in.
+ *
+ * @return int Zero if the vertices were staged, non-zero if they do not fit the ring this frame.
+ */
+int vertex_pool_upload_staged(vertex_pool_allocation_t *allocation, size_t offset, const void *vertices, size_t count,
+                              staging_ring_t *staging);
+
+/**
+ * @brief Sets the origin the vertices of an allocated range are relative to.
+ *
+ * @param allocation The allocation to set the origin of.
+ * @param origin The origin of the range.
+ */
+void vertex_pool_set_origin(vertex_pool_allocation_t *allocation, vec3s origin);
+
+/**
+ * @brief Moves allocations down into the holes left by freed ones, copying on the GPU.
+ *
+ * Allocations are moved from the end of the pool into the lowest hole they fit, one at a time, until the given
+ * number of vertices was moved. Calling it every frame with a small budget compacts the pool over time.
+ *
+ * @param pool The pool to defragment.
+ * @param max_vertices The maximum number of vertices to move.
+ *
+ * @return size_t The number of vertices moved.
+ */
+size_t vertex_pool_defragment(vertex_pool_t *pool, size_t max_vertices);
+
+/**
+ * @brief Binds the vertex array of the pool for drawing, and its origins to `VERTEX_POOL_ORIGIN_SLOT`.
+ *
+ * @param pool The pool to bind.
+ */
+void vertex_pool_bind(vertex_pool_t *pool);
+
+/**
+ * @brief Returns the number of vertices the pool holds.
+ *
+ * @param pool The pool.
+ *
+ * @return size_t The capacity of the pool, in vertices.
+ */
+size_t vertex_pool_get_capacity(vertex_pool_t *pool);
+
+/**
+ * @brief Returns the number of vertices allocated from the pool.
+ *
+ * @param pool The pool.
+ *
+ * @return size_t The number of allocated vertices.
+ */
+size_t vertex_pool_get_used(vertex_pool_t *pool);
@@ -1,27 +1,35 @@
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <cglm/struct.h>
 
-#include "graphics/tilemap.h"
-#include "graphics/vertex.h"
+#include "world/chunk_vertex.h"
 
-typedef enum {
+typedef uint16_t block_id_t;
+
+// Blocks the engine refers to directly. Their ids must match the block definition file.
+enum {
     BLOCK_ID_AIR         = 0,
     BLOCK_ID_STONE       = 1,
     BLOCK_ID_COBBLESTONE = 2,
     BLOCK_ID_DIRT        = 3,
     BLOCK_ID_GRASS       = 4,
-} block_id_t;
+};
+
+#define BLOCK_ID_MAX UINT16_MAX
+
+typedef int32_t tile_id_t;
+
+#define TILE_ID_NONE (-1)
+
+// Tiles are packed into 16 bits of a chunk vertex
+#define TILE_ID_MAX UINT16_MAX
 
 typedef enum {
-    TILE_ID_NONE         = -1,
-    TILE_ID_STONE        = 0,
-    TILE_ID_COBBLESTONE  = 1,
-    TILE_ID_DIRT         = 2,
-    TILE_ID_GRASS_TOP    = 3,
-    TILE_ID_GRASS_SIDE   = 4,
-    TILE_ID_GRASS_BOTTOM = TILE_ID_DIRT,
-} tile_id_t;
+    BLOCK_FLAG_OPAQUE = 1 << 0,
+} block_flag_t;
 
 typedef enum {
     BLOCK_FACE_TOP    = 0,
@@ -33,7 +41,7 @@ typedef enum {
 } block_face_t;
 
 typedef struct {
-    vertex_t vertices[4];
+    chunk_vertex_t vertices[4];
 } block_face_data_t;
 
 typedef struct {
@@ -44,6 +52,54 @@ typedef struct {
     tile_id_t values[6];
 } block_tiles_t;
 
+/**
+ * Block properties compiled from the block definition file into flat tables indexed by block id, so lookups on hot
+ * paths are a single indexed load. Ids without a definition behave like air.
+ */
+typedef struct {
+    size_t count;
+    char **names;
+
+    // Covers every possible id, so the opacity of undefined ids reads as zero without a bounds check
+    uint64_t *opaque;
+    uint8_t *flags;
+    block_tiles_t *tiles;
+    block_faces_t *face_templates;
+} block_registry_t;
+
+extern block_registry_t block_registry;
+
+/**
+ * @brief Loads the block definitions from a file and compiles them into the block registry.
+ *
+ * Every definition starts with a `block <id> <name>` line, followed by optional `flags <flag>...` and `tiles` lines.
+ * `tiles` takes either one tile for every face or six tiles in top, bottom, front, back, left, right order.
+ *
+ * @param filename The path to the block definition file.
+ *
+ * @return int Zero if the registry was loaded successfully, non-zero otherwise.
+ */
+int block_registry_load(const char *filename);
+
+/**
+ * @brief Releases the tables of the block registry.
+ */
+void block_registry_free();
+
+/**
+ * @brief Finds a block by name.
+ *
+ * @param name The name of the block.
+ *
+ * @return block_id_t The id of the block, or `BLOCK_ID_AIR` if no block has that name.
+ */
+block_id_t block_registry_find(const char *name);
+
+// Ids past the registered ones look up the tables of air
+static inline block_id_t block_registry_index(block_id_t block) {
+    return block < block_registry.count ? block : BLOCK_ID_AIR;
+}
+
 /**
  * @brief Checks if a block is opaque.
  *
@@ -51,7 +107,19 @@ typedef struct {
  *
  * @return int Returns 1 if the block is opaque, 0 otherwise.
  */
-int block_is_opaque(block_id_t block);
+static inline int block_is_opaque(block_id_t block) { return (block_registry.opaque[block >> 6] >> (block & 63)) & 1; }
+
+/**
+ * @brief Retrieves the tile of a single block face.
+ *
+ * @param block The block to retrieve the tile for.
+ * @param face The face to retrieve the tile for.
+ *
+ * @return tile_id_t The tile of the face.
+ */
+static inline tile_id_t block_get_tile(block_id_t block, block_face_t face) {
+    return block_registry.tiles[block_registry_index(block)].values[face];
+}
 
 /**
  * @brief Retrieves the tiles for a block.
@@ -62,14 +130,60 @@ int block_is_opaque(block_id_t block);
  */
 block_tiles_t block_get_tiles(block_id_t block);
 
+/**
+ * @brief Retrieves a single face quad for a block.
+ *
+ * The quad spans `size.x` blocks along the face's u axis and `size.y` blocks along its v axis. Texture coordinates are
+ * expressed in tiles, so a quad larger than one block repeats its tile.
+ *
+ * @param block The block to retrieve the face for.
+ * @param face The face to retrieve.
+ * @param position The chunk local position of the quad's minimum corner.
+ * @param size The size of the quad in blocks along the face's u and v axes.
+ * @param data The face quad.
+ */
+void block_get_face(block_id_t block, block_face_t face, ivec3s position, ivec2s size, block_face_data_t *data);
+
+/**
+ * @brief Retrieves the precomputed quad of a single block face placed at the chunk origin.
+ *
+ * Packed positions add up field by field, so the face of a block at `position` is the template with
+ * `CHUNK_VERTEX_PACK_POSITION(position)` added to every vertex position.
+ *
+ * @param block The block to retrieve the face for.
+ * @param face The face to retrieve.
+ *
+ * @return const block_face_data_t* The face quad.
+ */
+static inline const block_face_data_t *block_get_face_template(block_id_t block, block_face_t face) {
+    return &block_registry.face_templates[block_registry_index(block)].values[face];
+}
+
+/**
+ * @brief Retrieves the axis the texture u coordinate of a face runs along.
+ *
+ * @param face The face to query.
+ *
+ * @return int The axis index (0 for x, 1 for y, 2 for z).
+ */
+int block_face_u_axis(block_face_t face);
+
+/**
+ * @brief Retrieves the axis the texture v coordinate of a face runs along.
+ *
+ * @param face The face to query.
+ *
+ * @return int The axis index (0 for x, 1 for y, 2 for z).
+ */
+int block_face_v_axis(block_face_t face);
+
 /**
  * @brief Retrieves the faces for a block.
  *
  * This function calculates the faces for the specified block at the given position.
  *
  * @param block The block to retrieve the faces for.
- * @param position The position of the block.
- * @param tilemap The tilemap to use for the block.
+ * @param position The chunk local position of the block.
  * @param faces The faces for the block.
  */
-void block_get_faces(block_id_t block, vec3s position, tilemap_t *tilemap, block_faces_t *faces);
+void block_get_faces(block_id_t block, ivec3s position, block_faces_t *faces);
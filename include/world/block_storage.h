@@ -0,0 +1,121 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "world/block.h"
+
+#define BLOCK_STORAGE_MAX_BITS 16
+
+/**
+ * Palette compressed block storage.
+ *
+ * Every cell stores an index into a small palette of distinct blocks. Indices are bit packed into 64-bit words using
+ * a power of two width (0, 1, 2, 4, 8 or 16 bits), so an index never straddles two words. A storage holding a single
+ * block type uses 0 bits per cell and allocates no index data at all.
+ */
+typedef struct {
+    block_id_t *palette;
+    uint32_t palette_size;
+
+    uint32_t bits;
+    uint64_t *data;
+
+    size_t volume;
+} block_storage_t;
+
+/**
+ * @brief Initializes a block storage filled with a single block.
+ *
+ * @param storage The storage to initialize.
+ * @param volume The number of cells in the storage.
+ * @param fill The block every cell is initialized to.
+ *
+ * @return int Zero if the storage was initialized successfully, non-zero otherwise.
+ */
+int block_storage_init(block_storage_t *storage, size_t volume, block_id_t fill);
+
+/**
+ * @brief Initializes a block storage as a deep copy of another one.
+ *
+ * @param storage The storage to initialize.
+ * @param source The storage to copy.
+ *
+ * @return int Zero if the storage was copied successfully, non-zero otherwise.
+ */
+int block_storage_copy(block_storage_t *storage, const block_storage_t *source);
+
+/**
+ * @brief Releases the memory owned by the block storage.
+ *
+ * @param storage The storage to free.
+ */
+void block_storage_free(block_storage_t *storage);
+
+/**
+ * @brief Retrieves the block stored at the specified index.
+ *
+ * @param storage The storage to read from.
+ * @param index The index of the cell.
+ *
+ * @return block_id_t The block stored in the cell.
+ */
+block_id_t block_storage_get(const block_storage_t *storage, size_t index);
+
+/**
+ * @brief Decodes every cell of the storage into a flat array.
+ *
+ * @param storage The storage to read from.
+ * @param blocks The output array, must have room for `volume` blocks.
+ */
+void block_storage_unpack(const block_storage_t *storage, block_id_t *blocks);
+
+/**
+ * @brief Replaces every cell of the storage with the blocks of a flat array.
+ *
+ * Cheaper than setting the cells one by one since the indices are written once at their final width.
+ *
+ * @param storage The storage to write to.
+ * @param blocks The blocks to store, must hold `volume` blocks.
+ *
+ * @return int Zero if the blocks were stored successfully, non-zero otherwise.
+ */
+int block_storage_pack(block_storage_t *storage, const block_id_t *blocks);
+
+/**
+ * @brief Stores a block at the specified index.
+ *
+ * The palette and the index width grow as needed when a new block type is stored.
+ *
+ * @param storage The storage to write to.
+ * @param index The index of the cell.
+ * @param block The block to store.
+ */
+void block_storage_set(block_storage_t *storage, size_t index, block_id_t block);
+
+/**
+ * @brief Fills the whole storage with a single block, dropping back to a 0 bit palette.
+ *
+ * @param storage The storage to fill.
+ * @param block The block to fill the storage with.
+ *
+ * @return int Zero if the storage was filled, non-zero if the palette could not be allocated. The storage is left
+ * untouched then.
+ */
+int block_storage_fill(block_storage_t *storage, block_id_t block);
+
+/**
+ * @brief Drops unused palette entries and narrows the index width if possible.
+ *
+ * @param storage The storage to compact.
+ */
+void block_storage_compact(block_storage_t *storage);
+
+/**
+ * @brief Returns the number of bytes of heap memory used by the storage.
+ *
+ * @param storage The storage to measure.
+ *
+ * @return size_t The memory used by the palette and the packed indices.
+ */
+size_t block_storage_memory_usage(const block_storage_t *storage);
@@ -3,21 +3,118 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#include "graphics/mesh.h"
-#include "graphics/tilemap.h"
+#include "core/arena.h"
+#include "graphics/vertex_pool.h"
 #include "world/block.h"
+#include "world/block_storage.h"
+#include "world/chunk_vertex.h"
 
 #define CHUNK_SIZE   16
 #define CHUNK_HEIGHT 256
 #define CHUNK_VOLUME (CHUNK_SIZE * CHUNK_SIZE * CHUNK_HEIGHT)
 
+#define CHUNK_SECTION_HEIGHT 16
+#define CHUNK_SECTION_COUNT  (CHUNK_HEIGHT / CHUNK_SECTION_HEIGHT)
+#define CHUNK_SECTION_VOLUME (CHUNK_SIZE * CHUNK_SIZE * CHUNK_SECTION_HEIGHT)
+
+// Index of a block inside a section's storage, `y` is relative to the section's bottom
+#define CHUNK_SECTION_INDEX(x, y, z) ((x) + (z) * CHUNK_SIZE + (y) * (CHUNK_SIZE * CHUNK_SIZE))
+
+// Vertex slot reserved for a section holding `count` vertices, with room to grow by a quarter plus 16 quads before
+// an edit forces a full chunk rebuild. Always a multiple of 4.
+#define CHUNK_SECTION_VERTEX_CAPACITY(count) ((((count) + (count) / 4) & ~(size_t)3) + 64)
+
+/**
+ * A 16x16x16 vertical slice of a chunk.
+ *
+ * `empty` is set when the section holds no opaque block and `full` when every block in it is opaque. Empty sections
+ * produce no geometry and full sections enclosed by other full sections are buried, so both can be skipped when
+ * meshing.
+ *
+ * Every section owns a slot of `vertex_capacity` vertices inside the chunk mesh, starting at `vertex_offset`. The first
+ * `vertex_count` vertices hold its quads and the rest are degenerate quads, so a section can be remeshed and patched
+ * in place as long as it still fits its slot. The index range covers the live quads only.
+ *
+ * `visibility` records which faces of the section see each other through its non-opaque blocks, as
+ * `CHUNK_VISIBILITY_BIT`s. It is refreshed along with the section's mesh.
+ */
 typedef struct {
+    block_storage_t blocks;
+    int opaque_count;
+
+    int empty;
+    int full;
+    int dirty;
+
+    size_t vertex_offset;
+    size_t vertex_count;
+    size_t vertex_capacity;
+    size_t index_offset;
+    size_t index_count;
+
+    uint32_t visibility;
+
+    // Last frame the renderer's visibility search reached the section
+    uint32_t visit_frame;
+} chunk_section_t;
+
+/**
+ * Generation stages a chunk goes through, in order. Generation and decoration only touch the chunk's own blocks, only
+ * meshing waits for the neighbors to be decorated since it reads their final border blocks.
+ */
+typedef enum {
+    CHUNK_STAGE_EMPTY     = 0,
+    CHUNK_STAGE_GENERATED = 1,
+    CHUNK_STAGE_DECORATED = 2,
+
+    // Handed over to the mesher, the mesh itself shows up once the meshing job lands
+    CHUNK_STAGE_MESHED = 3,
+} chunk_stage_t;
+
+typedef struct chunk {
     ivec2s position;
-    block_id_t *blocks;
-    mesh_t *mesh;
+    chunk_section_t sections[CHUNK_SECTION_COUNT];
+
+    chunk_stage_t stage;
+
+    // Number of pipeline jobs reading or writing the live chunk, the main thread must leave its blocks alone meanwhile.
+    // Read through `chunk_is_busy`.
+    int busy;
+
+    // Times in a row the next stage failed, and the pipeline update it is retried at
+    uint32_t stage_failures;
+    uint32_t stage_retry;
+
+    // Loaded neighbors, indexed by `enum chunk_neighbor` and kept up to date by the world. Entries may be NULL.
+    struct chunk *neighbors[4];
+
+    // Index of the chunk in the world's chunk list
+    size_t world_index;
+
+    // Vertices of the chunk inside the renderer's chunk pool, laid out as the section slots. Unallocated while the
+    // chunk has no mesh.
+    vertex_pool_allocation_t geometry;
+    int has_mesh;
     int dirty;
+
+    // Set while a mesh for the chunk is being built off the main thread
+    int meshing;
+
+    // Set while the chunk is in the world's dirty queue
+    int queued;
+
+    // Occlusion query of the chunk's bounds, zero until the renderer first queries it. `occluded` holds the last result
+    // read back and `occlusion_pending` is set while a result is on its way.
+    uint32_t occlusion_query;
+    int occlusion_pending;
+    int occluded;
 } chunk_t;
 
+typedef enum {
+    CHUNK_MESH_MODE_NAIVE  = 0,
+    CHUNK_MESH_MODE_GREEDY = 1,
+} chunk_mesh_mode_t;
+
 enum chunk_neighbor {
     CHUNK_NEIGHBOR_FRONT,
     CHUNK_NEIGHBOR_BACK,
@@ -25,6 +122,39 @@ enum chunk_neighbor {
     CHUNK_NEIGHBOR_RIGHT,
 };
 
+/**
+ * @brief Checks if pipeline jobs hold the chunk. The count is changed atomically, also from workers, so it must only be
+ * read through this.
+ *
+ * @param chunk The chunk to check.
+ *
+ * @return int Non-zero if the chunk is busy.
+ */
+static inline int chunk_is_busy(chunk_t *chunk) { return __atomic_load_n(&chunk->busy, __ATOMIC_ACQUIRE) != 0; }
+
+/**
+ * Read-only copy of a chunk's blocks and of its neighbors', safe to mesh on another thread while the live chunks keep
+ * changing. Snapshot chunks have no mesh.
+ */
+typedef struct {
+    chunk_t chunk;
+    chunk_t neighbors[4];
+
+    // Entries are NULL for missing neighbors, indexed by `enum chunk_neighbor`
+    chunk_t *neighbor_pointers[4];
+} chunk_snapshot_t;
+
+/**
+ * Vertices built for a chunk, laid out as consecutive section slots padded with degenerate quads.
+ */
+typedef struct {
+    chunk_vertex_t *vertices;
+    size_t vertex_count;
+    size_t section_vertex_counts[CHUNK_SECTION_COUNT];
+    size_t section_vertex_capacities[CHUNK_SECTION_COUNT];
+    uint32_t section_visibilities[CHUNK_SECTION_COUNT];
+} chunk_mesh_data_t;
+
 /**
  * @brief Creates a new chunk.
  *
@@ -54,14 +184,81 @@ block_id_t chunk_get_block(chunk_t *chunk, ivec3s position);
 void chunk_set_block(chunk_t *chunk, ivec3s position, block_id_t block);
 
 /**
- * @brief Generates the mesh for the chunk.
+ * @brief Replaces every block of a section at once.
+ *
+ * @param chunk The chunk the section belongs to.
+ * @param section The index of the section.
+ * @param blocks The blocks of the section, indexed by `CHUNK_SECTION_INDEX`.
+ *
+ * @return int Zero if the blocks were set successfully, non-zero otherwise.
+ */
+int chunk_set_section_blocks(chunk_t *chunk, int section, const block_id_t *blocks);
+
+/**
+ * @brief Copies the blocks of a chunk and of its neighbors into a snapshot.
+ *
+ * @param snapshot The snapshot to initialize.
+ * @param chunk The chunk to copy.
+ * @param neighbors The neighboring chunks, indexed by `enum chunk_neighbor`. Entries may be NULL.
+ *
+ * @return int Zero if the snapshot was created successfully, non-zero otherwise.
+ */
+int chunk_snapshot_create(chunk_snapshot_t *snapshot, chunk_t *chunk, chunk_t **neighbors);
+
+/**
+ * @brief Releases the block copies owned by the snapshot.
+ *
+ * @param snapshot The snapshot to free.
+ */
+void chunk_snapshot_free(chunk_snapshot_t *snapshot);
+
+/**
+ * @brief Builds the vertices of a chunk.
+ *
+ * Only reads blocks, so it can run on any thread as long as the chunk and its neighbors are not modified meanwhile,
+ * which holds for snapshots.
+ *
+ * @param chunk The chunk to build the vertices for.
+ * @param neighbors The neighboring chunks, indexed by `enum chunk_neighbor`. Entries may be NULL.
+ * @param mode The meshing mode.
+ * @param scratch The arena the vertices are built in, must have room for `CHUNK_MESH_SCRATCH_SIZE` bytes.
+ * @param data The output mesh data, its vertices point into the scratch arena.
+ *
+ * @return int Zero if the vertices were built successfully, non-zero otherwise.
+ */
+int chunk_build_mesh(chunk_t *chunk, chunk_t **neighbors, chunk_mesh_mode_t mode, arena_t *scratch,
+                     chunk_mesh_data_t *data);
+
+/**
+ * @brief Uploads built vertices into the chunk's range of a vertex pool. Must be called on the thread owning the GL
+ * context.
+ *
+ * The chunk keeps its range if the vertices fit it, otherwise the range is reallocated.
+ *
+ * @param chunk The chunk to upload the mesh of.
+ * @param data The vertices built by `chunk_build_mesh`.
+ * @param pool The pool holding the chunk vertices.
+ * @param staging The ring to stage the vertices in, NULL to upload them directly. The vertices must fit the rest of
+ * its current frame, they are uploaded directly with a warning if staging them fails.
+ *
+ * @return int Zero if the mesh was uploaded successfully, non-zero otherwise.
+ */
+int chunk_upload_mesh(chunk_t *chunk, const chunk_mesh_data_t *data, vertex_pool_t *pool, staging_ring_t *staging);
+
+/**
+ * @brief Remeshes a single section and patches its slot of the chunk's vertices. Must be called on the thread owning
+ * the GL context.
+ *
+ * @param chunk The chunk the section belongs to, must have a mesh.
+ * @param section The index of the section.
+ * @param neighbors The neighboring chunks, indexed by `enum chunk_neighbor`. Entries may be NULL.
+ * @param mode The meshing mode.
+ * @param scratch The arena the vertices are built in, must have room for `CHUNK_SECTION_SCRATCH_SIZE` bytes.
  *
- * @param chunk The chunk to generate the mesh for.
- * @param shader_program The shader program to use for the mesh.
- * @param tilemap The tilemap to use for the mesh.
- * @param neighbors The neighboring chunks.
+ * @return int Zero if the section was updated, non-zero if it outgrew its slot and the chunk needs a full rebuild.
  */
-void chunk_generate_mesh(chunk_t *chunk, shader_program_t *shader_program, tilemap_t *tilemap, chunk_t **neighbors);
+int chunk_update_section_mesh(chunk_t *chunk, int section, chunk_t **neighbors, chunk_mesh_mode_t mode,
+                              arena_t *scratch);
 
 /**
  * @brief Destroys the chunk and releases any associated resources.
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "world/chunk.h"
+#include "world/chunk_vertex.h"
+
+// Upper bound of visible faces in a single section: a 3D checkerboard exposes every face of half of the blocks, plus
+// the outward faces along the section border.
+#define CHUNK_MESHER_MAX_SECTION_QUADS (CHUNK_SECTION_VOLUME * 3 + CHUNK_SIZE * CHUNK_SIZE * 6)
+
+// Worst case scratch memory needed by `chunk_update_section_mesh`: a section slot at the quad bound
+#define CHUNK_SECTION_SCRATCH_SIZE \
+    (CHUNK_SECTION_VERTEX_CAPACITY(CHUNK_MESHER_MAX_SECTION_QUADS * 4) * sizeof(chunk_vertex_t) + ARENA_ALIGNMENT)
+
+// Worst case scratch memory needed by `chunk_build_mesh`: every section slot at the quad bound
+#define CHUNK_MESH_SCRATCH_SIZE (CHUNK_SECTION_COUNT * (CHUNK_SECTION_SCRATCH_SIZE - ARENA_ALIGNMENT) + ARENA_ALIGNMENT)
+
+/**
+ * @brief Builds the quads of a single chunk section.
+ *
+ * In naive mode every visible block face becomes one quad. In greedy mode coplanar visible faces sharing the same tile
+ * are merged into maximal rectangles.
+ *
+ * @param chunk The chunk the section belongs to.
+ * @param section The index of the section to build.
+ * @param neighbors The neighboring chunks, indexed by `enum chunk_neighbor`. Entries may be NULL.
+ * @param mode The meshing mode.
+ * @param vertices The output vertices, four per quad. Must have room for `CHUNK_MESHER_MAX_SECTION_QUADS` quads.
+ *
+ * @return size_t The number of vertices written.
+ */
+size_t chunk_mesher_build_section(chunk_t *chunk, int section, chunk_t **neighbors, chunk_mesh_mode_t mode,
+                                  chunk_vertex_t *vertices);
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "world/world.h"
+
+// Rings of chunks around a meshed chunk needed to get it through the earlier stages, meshing needs decorated neighbors
+#define CHUNK_PIPELINE_MARGIN 1
+
+typedef struct chunk_pipeline chunk_pipeline_t;
+
+/**
+ * @brief Creates a new chunk pipeline running its stages on the job system.
+ *
+ * @param max_jobs The maximum number of stage jobs in flight.
+ *
+ * @return chunk_pipeline_t* The created pipeline, or NULL on failure.
+ */
+chunk_pipeline_t *chunk_pipeline_create(int max_jobs);
+
+/**
+ * @brief Destroys the specified chunk pipeline, after waiting for its jobs in flight. Must be called on the main
+ * thread.
+ *
+ * @param pipeline The pipeline to destroy.
+ */
+void chunk_pipeline_destroy(chunk_pipeline_t *pipeline);
+
+/**
+ * @brief Schedules the next stage of every chunk that can advance.
+ *
+ * Generation and decoration run as soon as a chunk is loaded, meshing waits for its four neighbors to be decorated.
+ * A chunk is marked busy until its job lands in a main thread job, nothing else touches its blocks meanwhile. Chunks
+ * reaching the meshed stage are queued in the world's dirty queue. Must be called on the main thread.
+ *
+ * @param pipeline The pipeline.
+ * @param world The world whose chunks are advanced.
+ *
+ * @return int The number of stage jobs scheduled by this call.
+ */
+int chunk_pipeline_update(chunk_pipeline_t *pipeline, world_t *world);
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "graphics/vertex.h"
+
+/**
+ * Packed chunk vertex, 8 bytes.
+ *
+ * `position` holds the chunk local position: x in bits 0-4, y in bits 5-13 and z in bits 14-18. Each axis stores
+ * values up to and including the chunk size, since quads end on the far side of the last block.
+ *
+ * `texture` holds the tile id in bits 0-15 and the texture coordinates, in tiles, in bits 16-20 (u) and 21-25 (v).
+ * The vertex shader turns the tile id into atlas coordinates.
+ */
+typedef struct {
+    uint32_t position;
+    uint32_t texture;
+} chunk_vertex_t;
+
+#define CHUNK_VERTEX_PACK_POSITION(x, y, z) ((uint32_t)(x) | (uint32_t)(y) << 5 | (uint32_t)(z) << 14)
+#define CHUNK_VERTEX_PACK_TEXTURE(tile, u, v) ((uint32_t)(tile) | (uint32_t)(u) << 16 | (uint32_t)(v) << 21)
+
+// Layout of `chunk_vertex_t`, both words reach the shader as a single `uvec2`
+#define CHUNK_VERTEX_LAYOUT_INIT {sizeof(chunk_vertex_t), 1, {{0, 2, VERTEX_ARRAY_DATA_TYPE_UNSIGNED_INT, 1, 0}}}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "world/chunk.h"
+
+/**
+ * Faces of a chunk section. The horizontal ones match `enum chunk_neighbor` and every face is followed or preceded by
+ * its opposite, so `face ^ 1` is the opposite face.
+ */
+enum chunk_face {
+    CHUNK_FACE_FRONT,
+    CHUNK_FACE_BACK,
+    CHUNK_FACE_LEFT,
+    CHUNK_FACE_RIGHT,
+    CHUNK_FACE_BOTTOM,
+    CHUNK_FACE_TOP,
+    CHUNK_FACE_COUNT,
+};
+
+// Bit of a section's visibility telling whether faces `a` and `b` see each other, the faces must differ
+#define CHUNK_VISIBILITY_BIT(a, b) (1u << ((a) < (b) ? (a) * CHUNK_FACE_COUNT + (b) : (b) * CHUNK_FACE_COUNT + (a)))
+
+// Visibility of a section whose faces all see each other, e.g. an empty one
+#define CHUNK_VISIBILITY_ALL 0x20c38f3eu
+
+/**
+ * @brief Computes which faces of a section see each other through its non-opaque blocks.
+ *
+ * Two faces see each other when a single region of connected non-opaque blocks touches both of them. Only reads
+ * blocks, so it can run on any thread as long as the chunk is not modified meanwhile.
+ *
+ * @param chunk The chunk the section belongs to.
+ * @param section The index of the section.
+ *
+ * @return uint32_t The `CHUNK_VISIBILITY_BIT`s of the connected face pairs.
+ */
+uint32_t chunk_visibility_build_section(chunk_t *chunk, int section);
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "core/noise.h"
+#include "world/chunk.h"
+
+/**
+ * Procedural terrain. A 2D fractal height field shapes the surface and 3D fractal noise carves caves below it.
+ */
+typedef struct {
+    noise_fbm_t height;
+    noise_fbm_t caves;
+
+    // Surface height at a height noise of zero, and the offset at the extremes of the noise
+    int base_height;
+    int height_amplitude;
+
+    // Blocks whose cave noise is above this value are carved out
+    float cave_threshold;
+} terrain_t;
+
+/**
+ * @brief Initializes the terrain parameters for a seed.
+ *
+ * @param terrain The terrain to initialize.
+ * @param seed The seed of the world.
+ */
+void terrain_init(terrain_t *terrain, uint32_t seed);
+
+/**
+ * @brief Fills a chunk with generated terrain.
+ *
+ * Only reads the terrain parameters, so chunks can be generated on any thread.
+ *
+ * @param terrain The terrain parameters.
+ * @param chunk The chunk to fill, expected to hold only air.
+ *
+ * @return int Zero if the chunk was generated successfully, non-zero otherwise.
+ */
+int terrain_generate_chunk(const terrain_t *terrain, chunk_t *chunk);
+
+/**
+ * @brief Places decorations on a generated chunk.
+ *
+ * Decorations crossing the chunk border are placed by every chunk they touch, each one only writing its own blocks.
+ * They are derived from the seed and the generated surface alone, so the result does not depend on the order chunks
+ * are decorated in, nor on which neighbors were reloaded since.
+ *
+ * @param terrain The terrain parameters.
+ * @param chunk The chunk to decorate.
+ *
+ * @return int Zero if the chunk was decorated successfully, non-zero otherwise.
+ */
+int terrain_decorate_chunk(const terrain_t *terrain, chunk_t *chunk);
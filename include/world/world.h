@@ -3,14 +3,38 @@
 #include <cglm/struct.h>
 
 #include "world/chunk.h"
+#include "world/terrain.h"
 
 typedef struct {
+    uint64_t key;
+    chunk_t *chunk;
+} world_chunk_slot_t;
+
+typedef struct {
+    // Loaded chunks, in no particular order
     chunk_t **chunks;
-    int size;
+    size_t chunk_count;
+    size_t chunk_capacity;
+
+    // Open addressing hash map from Morton coded chunk positions to chunks, with linear probing. Empty slots have a
+    // NULL chunk and the capacity is a power of two.
+    world_chunk_slot_t *slots;
+    size_t slot_capacity;
+
+    // Chunks waiting to be remeshed, every chunk is queued at most once
+    chunk_t **dirty_chunks;
+    size_t dirty_count;
+    size_t dirty_capacity;
+
+    terrain_t terrain;
 } world_t;
 
 typedef struct {
+    // Number of chunks loaded along each axis when the world is created, starting at the origin
     int size;
+
+    // Seed of the terrain generator
+    uint32_t seed;
 } world_settings_t;
 
 /**
@@ -37,6 +61,62 @@ void world_destroy(world_t *world);
  * @param world The world to retrieve the chunk from.
  * @param x The x-coordinate of the chunk.
  * @param y The y-coordinate of the chunk.
- * @return chunk_t* The chunk at the specified position.
+ * @return chunk_t* The chunk at the specified position, or NULL if it is not loaded.
  */
 chunk_t *world_get_chunk(world_t *world, int x, int y);
+
+/**
+ * @brief Creates the chunk at the specified position, unless it is already loaded.
+ *
+ * The chunk starts out empty and is filled by the chunk pipeline. Loaded neighbors are linked to the new chunk and
+ * meshed ones are queued for remeshing, since their border faces may now be hidden.
+ *
+ * @param world The world to load the chunk into.
+ * @param position The position of the chunk.
+ *
+ * @return chunk_t* The loaded chunk, or NULL on failure.
+ */
+chunk_t *world_load_chunk(world_t *world, ivec2s position);
+
+/**
+ * @brief Removes a chunk from the world and destroys it.
+ *
+ * Chunks being meshed or busy in the chunk pipeline cannot be unloaded until their jobs have landed.
+ *
+ * @param world The world to unload the chunk from.
+ * @param chunk The chunk to unload.
+ *
+ * @return int Zero if the chunk was unloaded, non-zero otherwise.
+ */
+int world_unload_chunk(world_t *world, chunk_t *chunk);
+
+/**
+ * @brief Retrieves the block at the specified world position.
+ *
+ * @param world The world to retrieve the block from.
+ * @param position The position of the block in world coordinates.
+ *
+ * @return block_id_t The block at the specified position, air outside of the loaded chunks and in chunks busy in the
+ * chunk pipeline.
+ */
+block_id_t world_get_block(world_t *world, ivec3s position);
+
+/**
+ * @brief Sets the block at the specified world position.
+ *
+ * Edits on a chunk border also dirty the section of the neighboring chunk that shares the border, and every affected
+ * chunk is queued for remeshing. Chunks that are not decorated yet or busy in the chunk pipeline ignore edits.
+ *
+ * @param world The world to set the block in.
+ * @param position The position of the block in world coordinates.
+ * @param block The block to set.
+ */
+void world_set_block(world_t *world, ivec3s position, block_id_t block);
+
+/**
+ * @brief Queues a chunk for remeshing, unless it is already queued.
+ *
+ * @param world The world the chunk belongs to.
+ * @param chunk The chunk to queue.
+ */
+void world_queue_dirty_chunk(world_t *world, chunk_t *chunk);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "graphics/camera.h"
 #include "graphics/shader_program.h"
 #include "graphics/tilemap.h"
 #include "world/world.h"
@@ -14,6 +15,10 @@ typedef struct {
     tilemap_t *tilemap;
     shader_program_t *block_shader;
     int draw_distance;
+    chunk_mesh_mode_t mesh_mode;
+
+    // Shader drawing chunk bounds for occlusion queries, NULL disables them
+    shader_program_t *bounds_shader;
 } world_renderer_settings_t;
 
 /**
@@ -38,6 +43,8 @@ void world_renderer_destroy(world_renderer_t *renderer);
  * @brief Prepares the specified world for rendering.
  * 
  * This function prepares the specified world for rendering by generating the meshes for each chunk.
+ * Vertices of dirty chunks are built on worker threads from block snapshots and uploaded by a later call once ready,
+ * so a chunk keeps its previous mesh for a few frames after changing.
  * 
  * @param renderer A pointer to the world renderer object.
  */
@@ -46,8 +53,12 @@ void world_renderer_prepare(world_renderer_t *renderer, world_t *world);
 /**
  * @brief Renders the specified world.
  *
+ * Chunks beyond the draw distance are skipped, the remaining ones are culled against the camera frustum, first as
+ * whole columns and then section by section. With occlusion queries enabled in the renderer state, chunks found hidden
+ * in an earlier frame are only drawn if their bounds pass a query issued after the visible chunks.
+ *
  * @param renderer A pointer to the world renderer object.
  * @param world A pointer to the world object to render.
- * @param camera_position The position of the camera.
+ * @param camera The camera to render the world from.
  */
-void world_renderer_render(world_renderer_t *renderer, world_t *world, vec3s camera_position);
+void world_renderer_render(world_renderer_t *renderer, world_t *world, camera_t *camera);
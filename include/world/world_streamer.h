@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cglm/struct.h>
+
+#include "world/world.h"
+
+typedef struct world_streamer world_streamer_t;
+
+typedef struct {
+    // Chunks closer than this many chunks to the center are loaded
+    int load_radius;
+
+    // Chunks farther than this many chunks from the center are unloaded, must be larger than the load radius so
+    // chunks on the edge do not thrash while the center moves back and forth
+    int unload_radius;
+
+    // Maximum number of chunks loaded and unloaded per update
+    int loads_per_update;
+    int unloads_per_update;
+} world_streamer_settings_t;
+
+/**
+ * @brief Creates a new world streamer.
+ *
+ * @param settings The settings to use for the streamer.
+ *
+ * @return world_streamer_t* The created streamer, or NULL on failure.
+ */
+world_streamer_t *world_streamer_create(world_streamer_settings_t settings);
+
+/**
+ * @brief Destroys the specified world streamer.
+ *
+ * @param streamer The streamer to destroy.
+ */
+void world_streamer_destroy(world_streamer_t *streamer);
+
+/**
+ * @brief Loads and unloads chunks around the specified center.
+ *
+ * Missing chunks are loaded nearest first, in rings spiraling out of the center. Chunks beyond the unload radius are
+ * unloaded farthest first. Both are spread over several updates according to the per-update budgets.
+ *
+ * @param streamer The streamer.
+ * @param world The world to stream chunks into.
+ * @param center The position of the chunk the camera is in.
+ *
+ * @return int The number of chunks loaded or unloaded.
+ */
+int world_streamer_update(world_streamer_t *streamer, world_t *world, ivec2s center);
@@ -0,0 +1,68 @@
+#include "core/arena.h"
+
+#include <stdlib.h>
+
+#include "core/log.h"
+
+int arena_init(arena_t *arena, size_t capacity) {
+    if (arena == NULL) {
+        LOG_ERROR("'arena_init' called with NULL arena");
+        return -1;
+    }
+
+    arena->data = malloc(capacity);
+    if (arena->data == NULL) {
+        LOG_ERROR("Failed to allocate %zu bytes of arena memory", capacity);
+        return -1;
+    }
+
+    arena->capacity         = capacity;
+    arena->offset           = 0;
+    arena->peak             = 0;
+    arena->allocated        = 0;
+    arena->allocation_count = 0;
+    return 0;
+}
+
+void arena_free(arena_t *arena) {
+    if (arena == NULL) {
+        LOG_ERROR("'arena_free' called with NULL arena");
+        return;
+    }
+
+    free(arena->data);
+    arena->data     = NULL;
+    arena->capacity = 0;
+    arena->offset   = 0;
+}
+
+void *arena_alloc(arena_t *arena, size_t size) {
+    if (arena == NULL) {
+        LOG_ERROR("'arena_alloc' called with NULL arena");
+        return NULL;
+    }
+
+    size_t offset = (arena->offset + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    if (offset > arena->capacity || size > arena->capacity - offset) {
+        LOG_ERROR("Arena out of memory: %zu bytes requested, %zu of %zu used", size, arena->offset, arena->capacity);
+        return NULL;
+    }
+
+    arena->offset = offset + size;
+    if (arena->offset > arena->peak) {
+        arena->peak = arena->offset;
+    }
+    arena->allocated += size;
+    ++arena->allocation_count;
+
+    return arena->data + offset;
+}
+
+void arena_reset(arena_t *arena) {
+    if (arena == NULL) {
+        LOG_ERROR("'arena_reset' called with NULL arena");
+        return;
+    }
+
+    arena->offset = 0;
+}
@@ -0,0 +1,404 @@
+#include "core/job_system.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "core/log.h"
+
+#define JOB_DEQUE_BASE_CAPACITY 64
+
+/**
+ * Ring buffer of jobs. The owner pushes and pops at the bottom, thieves take from the top, so the owner works on its
+ * most recent and cache warm jobs while thieves take the oldest ones.
+ */
+typedef struct {
+    job_t *entries;
+    size_t capacity;
+    size_t head;
+    size_t count;
+
+    pthread_mutex_t mutex;
+} job_deque_t;
+
+typedef struct {
+    pthread_t thread;
+    int index;
+    job_deque_t lanes[JOB_PRIORITY_COUNT];
+} job_worker_t;
+
+typedef struct {
+    job_worker_t *workers;
+    int thread_count;
+
+    // Workers whose thread is running, all of them once initialization succeeded
+    int started_count;
+
+    // Jobs for the main thread, in submission order
+    job_deque_t main_thread_jobs;
+    pthread_t main_thread;
+
+    // Jobs sitting in the worker deques, workers sleep while it is zero
+    int queued;
+
+    // Worker jobs submitted and not finished yet, queued or running. A job may still submit continuations until it
+    // finished, which happens before it leaves this count.
+    int pending;
+
+    // Round robin cursor spreading jobs submitted from outside the workers
+    unsigned int next_worker;
+
+    int stopping;
+    pthread_mutex_t sleep_mutex;
+    pthread_cond_t job_available;
+} job_system_t;
+
+static job_system_t job_system;
+
+// Index of the worker running on this thread, the main thread uses `thread_count` and other threads -1
+static __thread int current_worker = -1;
+
+static int deque_init(job_deque_t *deque) {
+    deque->entries = malloc(JOB_DEQUE_BASE_CAPACITY * sizeof(job_t));
+    if (deque->entries == NULL) {
+        LOG_ERROR("Failed to allocate job deque");
+        return -1;
+    }
+
+    deque->capacity = JOB_DEQUE_BASE_CAPACITY;
+    deque->head     = 0;
+    deque->count    = 0;
+    pthread_mutex_init(&deque->mutex, NULL);
+    return 0;
+}
+
+static void deque_free(job_deque_t *deque) {
+    if (deque->entries == NULL) {
+        return;
+    }
+
+    pthread_mutex_destroy(&deque->mutex);
+    free(deque->entries);
+    deque->entries = NULL;
+}
+
+static int deque_push(job_deque_t *deque, const job_t *job) {
+    pthread_mutex_lock(&deque->mutex);
+    if (deque->count == deque->capacity) {
+        size_t capacity = deque->capacity * 2;
+        job_t *entries  = malloc(capacity * sizeof(job_t));
+        if (entries == NULL) {
+            pthread_mutex_unlock(&deque->mutex);
+            LOG_ERROR("Failed to grow job deque");
+            return -1;
+        }
+
+        for (size_t i = 0; i < deque->count; ++i) {
+            entries[i] = deque->entries[(deque->head + i) % deque->capacity];
+        }
+
+        free(deque->entries);
+        deque->entries  = entries;
+        deque->capacity = capacity;
+        deque->head     = 0;
+    }
+
+    deque->entries[(deque->head + deque->count) % deque->capacity] = *job;
+    ++deque->count;
+    pthread_mutex_unlock(&deque->mutex);
+    return 0;
+}
+
+static int deque_pop(job_deque_t *deque, job_t *job) {
+    pthread_mutex_lock(&deque->mutex);
+    int found = deque->count > 0;
+    if (found) {
+        --deque->count;
+        *job = deque->entries[(deque->head + deque->count) % deque->capacity];
+    }
+    pthread_mutex_unlock(&deque->mutex);
+    return found;
+}
+
+static int deque_steal(job_deque_t *deque, job_t *job) {
+    pthread_mutex_lock(&deque->mutex);
+    int found = deque->count > 0;
+    if (found) {
+        *job        = deque->entries[deque->head];
+        deque->head = (deque->head + 1) % deque->capacity;
+        --deque->count;
+    }
+    pthread_mutex_unlock(&deque->mutex);
+    return found;
+}
+
+static void run_job(const job_t *job, int worker) {
+    job->function(job->arg, worker);
+    if (job->counter) {
+        __atomic_sub_fetch(&job->counter->value, 1, __ATOMIC_RELEASE);
+    }
+}
+
+// Runs a job taken from the worker deques
+static void run_worker_job(const job_t *job, int worker) {
+    run_job(job, worker);
+    __atomic_sub_fetch(&job_system.pending, 1, __ATOMIC_RELEASE);
+}
+
+// Takes the highest priority job available to the thread, from its own deque first
+static int find_job(int worker, job_t *job) {
+    int count = job_system.thread_count;
+    for (int lane = 0; lane < JOB_PRIORITY_COUNT; ++lane) {
+        if (worker >= 0 && worker < count && deque_pop(&job_system.workers[worker].lanes[lane], job)) {
+            __atomic_sub_fetch(&job_system.queued, 1, __ATOMIC_RELAXED);
+            return 1;
+        }
+
+        int start = worker >= 0 ? worker + 1 : 0;
+        for (int i = 0; i < count; ++i) {
+            int victim = (start + i) % count;
+            if (victim != worker && deque_steal(&job_system.workers[victim].lanes[lane], job)) {
+                __atomic_sub_fetch(&job_system.queued, 1, __ATOMIC_RELAXED);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static void *worker_main(void *arg) {
+    job_worker_t *worker = arg;
+    current_worker       = worker->index;
+
+    job_t job;
+    for (;;) {
+        if (find_job(worker->index, &job)) {
+            run_worker_job(&job, worker->index);
+            continue;
+        }
+
+        pthread_mutex_lock(&job_system.sleep_mutex);
+        while (__atomic_load_n(&job_system.queued, __ATOMIC_ACQUIRE) <= 0 && !job_system.stopping) {
+            pthread_cond_wait(&job_system.job_available, &job_system.sleep_mutex);
+        }
+        int done = job_system.stopping && __atomic_load_n(&job_system.queued, __ATOMIC_ACQUIRE) <= 0;
+        pthread_mutex_unlock(&job_system.sleep_mutex);
+
+        if (done) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+static int is_main_thread() { return pthread_equal(pthread_self(), job_system.main_thread); }
+
+int job_system_init(job_system_settings_t settings) {
+    int thread_count = settings.thread_count > 0 ? settings.thread_count : job_system_default_thread_count();
+
+    job_system.workers = calloc(thread_count, sizeof(job_worker_t));
+    if (job_system.workers == NULL) {
+        LOG_ERROR("Failed to allocate job system workers");
+        return -1;
+    }
+
+    job_system.thread_count  = thread_count;
+    job_system.started_count = 0;
+    job_system.main_thread   = pthread_self();
+    job_system.queued        = 0;
+    job_system.pending       = 0;
+    job_system.next_worker   = 0;
+    job_system.stopping      = 0;
+    pthread_mutex_init(&job_system.sleep_mutex, NULL);
+    pthread_cond_init(&job_system.job_available, NULL);
+    current_worker = thread_count;
+
+    int failed = deque_init(&job_system.main_thread_jobs) != 0;
+    for (int i = 0; i < thread_count && !failed; ++i) {
+        for (int lane = 0; lane < JOB_PRIORITY_COUNT && !failed; ++lane) {
+            failed = deque_init(&job_system.workers[i].lanes[lane]) != 0;
+        }
+    }
+
+    // Every deque must exist before the first worker starts stealing
+    for (int i = 0; i < thread_count && !failed; ++i) {
+        job_system.workers[i].index = i;
+        if (pthread_create(&job_system.workers[i].thread, NULL, worker_main, &job_system.workers[i]) != 0) {
+            LOG_ERROR("Failed to create job system worker %d", i);
+            failed = 1;
+            break;
+        }
+        ++job_system.started_count;
+    }
+
+    if (failed) {
+        job_system_deinit();
+        return -1;
+    }
+
+    LOG_INFO("Job system initialized with %d workers", job_system.thread_count);
+    return 0;
+}
+
+void job_system_deinit() {
+    // Help draining the workers, which may still submit main thread jobs and the other way around. Deques only all
+    // exist once a worker was started.
+    job_t job;
+    while (job_system.started_count > 0) {
+        // Read before looking at the deques: once no worker job is pending, their continuations are all queued
+        int pending = __atomic_load_n(&job_system.pending, __ATOMIC_ACQUIRE);
+        if (deque_steal(&job_system.main_thread_jobs, &job)) {
+            run_job(&job, current_worker);
+        } else if (find_job(current_worker, &job)) {
+            run_worker_job(&job, current_worker);
+        } else if (pending > 0) {
+            sched_yield();
+        } else {
+            break;
+        }
+    }
+
+    pthread_mutex_lock(&job_system.sleep_mutex);
+    job_system.stopping = 1;
+    pthread_cond_broadcast(&job_system.job_available);
+    pthread_mutex_unlock(&job_system.sleep_mutex);
+
+    for (int i = 0; i < job_system.started_count; ++i) {
+        pthread_join(job_system.workers[i].thread, NULL);
+    }
+
+    for (int i = 0; i < job_system.thread_count; ++i) {
+        for (int lane = 0; lane < JOB_PRIORITY_COUNT; ++lane) {
+            deque_free(&job_system.workers[i].lanes[lane]);
+        }
+    }
+    free(job_system.workers);
+    deque_free(&job_system.main_thread_jobs);
+
+    pthread_mutex_destroy(&job_system.sleep_mutex);
+    pthread_cond_destroy(&job_system.job_available);
+
+    job_system.workers       = NULL;
+    job_system.thread_count  = 0;
+    job_system.started_count = 0;
+    current_worker           = -1;
+
+    LOG_INFO("Job system deinitialized");
+}
+
+int job_system_submit(const job_t *job) {
+    if (job == NULL || job->function == NULL) {
+        LOG_ERROR("'job_system_submit' called with NULL job");
+        return -1;
+    }
+
+    if (job->priority < 0 || job->priority >= JOB_PRIORITY_COUNT) {
+        LOG_ERROR("'job_system_submit' called with invalid priority %d", job->priority);
+        return -1;
+    }
+
+    if (job_system.thread_count == 0) {
+        LOG_ERROR("'job_system_submit' called without a running job system");
+        return -1;
+    }
+
+    int worker = current_worker;
+    if (worker < 0 || worker >= job_system.thread_count) {
+        worker = __atomic_fetch_add(&job_system.next_worker, 1, __ATOMIC_RELAXED) % job_system.thread_count;
+    }
+
+    if (job->counter) {
+        __atomic_add_fetch(&job->counter->value, 1, __ATOMIC_RELAXED);
+    }
+    __atomic_add_fetch(&job_system.pending, 1, __ATOMIC_RELAXED);
+
+    if (deque_push(&job_system.workers[worker].lanes[job->priority], job) != 0) {
+        if (job->counter) {
+            __atomic_sub_fetch(&job->counter->value, 1, __ATOMIC_RELAXED);
+        }
+        __atomic_sub_fetch(&job_system.pending, 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+
+    __atomic_add_fetch(&job_system.queued, 1, __ATOMIC_RELEASE);
+    pthread_mutex_lock(&job_system.sleep_mutex);
+    pthread_cond_signal(&job_system.job_available);
+    pthread_mutex_unlock(&job_system.sleep_mutex);
+    return 0;
+}
+
+int job_system_submit_main_thread(const job_t *job) {
+    if (job == NULL || job->function == NULL) {
+        LOG_ERROR("'job_system_submit_main_thread' called with NULL job");
+        return -1;
+    }
+
+    if (job->counter) {
+        __atomic_add_fetch(&job->counter->value, 1, __ATOMIC_RELAXED);
+    }
+
+    if (deque_push(&job_system.main_thread_jobs, job) != 0) {
+        if (job->counter) {
+            __atomic_sub_fetch(&job->counter->value, 1, __ATOMIC_RELAXED);
+        }
+        return -1;
+    }
+
+    return 0;
+}
+
+int job_system_run_main_thread_jobs() {
+    if (!is_main_thread()) {
+        LOG_ERROR("'job_system_run_main_thread_jobs' called outside of the main thread");
+        return 0;
+    }
+
+    pthread_mutex_lock(&job_system.main_thread_jobs.mutex);
+    size_t count = job_system.main_thread_jobs.count;
+    pthread_mutex_unlock(&job_system.main_thread_jobs.mutex);
+
+    int run = 0;
+    job_t job;
+    while (run < (int)count && deque_steal(&job_system.main_thread_jobs, &job)) {
+        run_job(&job, current_worker);
+        ++run;
+    }
+    return run;
+}
+
+void job_system_wait(job_counter_t *counter) {
+    if (counter == NULL) {
+        LOG_ERROR("'job_system_wait' called with NULL counter");
+        return;
+    }
+
+    int main_thread = is_main_thread();
+    job_t job;
+    while (__atomic_load_n(&counter->value, __ATOMIC_ACQUIRE) > 0) {
+        if (main_thread && deque_steal(&job_system.main_thread_jobs, &job)) {
+            run_job(&job, current_worker);
+        } else if (find_job(current_worker, &job)) {
+            run_worker_job(&job, current_worker);
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+int job_counter_get(const job_counter_t *counter) {
+    if (counter == NULL) {
+        LOG_ERROR("'job_counter_get' called with NULL counter");
+        return 0;
+    }
+
+    return __atomic_load_n(&counter->value, __ATOMIC_ACQUIRE);
+}
+
+int job_system_get_worker_count() { return job_system.thread_count + 1; }
+
+int job_system_default_thread_count() {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 1 ? (int)cpus - 1 : 1;
+}
@@ -0,0 +1,544 @@
+#include "core/noise.h"
+
+#include "core/log.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define NOISE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(NOISE_SSE2) && defined(__GNUC__)
+#define NOISE_AVX2
+#define NOISE_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+// Lattice hash multipliers, one per axis
+#define HASH_X 0x27D4EB2Du
+#define HASH_Y 0x165667B1u
+#define HASH_Z 0x9E3779B1u
+
+// Finalizer multipliers mixing the combined lattice coordinates
+#define HASH_MIX_1 0x2C1B3C6Du
+#define HASH_MIX_2 0x297A2D39u
+
+// Kernel forced by `noise_set_kernel`, negative while the widest supported kernel is used
+static int kernel_override = -1;
+
+// The vector kernels below mirror these functions operation for operation, so every kernel rounds exactly like the
+// scalar reference and chunks generate identically on every machine.
+
+static uint32_t hash(uint32_t seed, int32_t x, int32_t y, int32_t z) {
+    uint32_t h = seed ^ ((uint32_t)x * HASH_X) ^ ((uint32_t)y * HASH_Y) ^ ((uint32_t)z * HASH_Z);
+    h ^= h >> 15;
+    h *= HASH_MIX_1;
+    h ^= h >> 12;
+    h *= HASH_MIX_2;
+    h ^= h >> 15;
+    return h;
+}
+
+static int32_t lattice_floor(float value) {
+    int32_t i = (int32_t)value;
+    return (float)i > value ? i - 1 : i;
+}
+
+static float fade(float t) { return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); }
+
+static float lerp(float a, float b, float t) { return a + t * (b - a); }
+
+// One of the four diagonal gradients
+static float gradient_2d(uint32_t h, float x, float y) { return ((h & 1) ? -x : x) + ((h & 2) ? -y : y); }
+
+// One of the twelve cube edge gradients, picked like in Perlin's improved noise
+static float gradient_3d(uint32_t h, float x, float y, float z) {
+    uint32_t c = h & 15;
+    float u    = c < 8 ? x : y;
+    float v    = c < 4 ? y : (c == 12 || c == 14) ? x : z;
+    return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+}
+
+float noise_2d(uint32_t seed, float x, float y) {
+    int32_t xi = lattice_floor(x);
+    int32_t yi = lattice_floor(y);
+    float xf   = x - (float)xi;
+    float yf   = y - (float)yi;
+
+    float n00 = gradient_2d(hash(seed, xi, yi, 0), xf, yf);
+    float n10 = gradient_2d(hash(seed, xi + 1, yi, 0), xf - 1.0f, yf);
+    float n01 = gradient_2d(hash(seed, xi, yi + 1, 0), xf, yf - 1.0f);
+    float n11 = gradient_2d(hash(seed, xi + 1, yi + 1, 0), xf - 1.0f, yf - 1.0f);
+
+    float u = fade(xf);
+    float v = fade(yf);
+    return lerp(lerp(n00, n10, u), lerp(n01, n11, u), v);
+}
+
+float noise_3d(uint32_t seed, float x, float y, float z) {
+    int32_t xi = lattice_floor(x);
+    int32_t yi = lattice_floor(y);
+    int32_t zi = lattice_floor(z);
+    float xf   = x - (float)xi;
+    float yf   = y - (float)yi;
+    float zf   = z - (float)zi;
+
+    float n000 = gradient_3d(hash(seed, xi, yi, zi), xf, yf, zf);
+    float n100 = gradient_3d(hash(seed, xi + 1, yi, zi), xf - 1.0f, yf, zf);
+    float n010 = gradient_3d(hash(seed, xi, yi + 1, zi), xf, yf - 1.0f, zf);
+    float n110 = gradient_3d(hash(seed, xi + 1, yi + 1, zi), xf - 1.0f, yf - 1.0f, zf);
+    float n001 = gradient_3d(hash(seed, xi, yi, zi + 1), xf, yf, zf - 1.0f);
+    float n101 = gradient_3d(hash(seed, xi + 1, yi, zi + 1), xf - 1.0f, yf, zf - 1.0f);
+    float n011 = gradient_3d(hash(seed, xi, yi + 1, zi + 1), xf, yf - 1.0f, zf - 1.0f);
+    float n111 = gradient_3d(hash(seed, xi + 1, yi + 1, zi + 1), xf - 1.0f, yf - 1.0f, zf - 1.0f);
+
+    float u = fade(xf);
+    float v = fade(yf);
+    float w = fade(zf);
+    return lerp(lerp(lerp(n000, n100, u), lerp(n010, n110, u), v), lerp(lerp(n001, n101, u), lerp(n011, n111, u), v),
+                w);
+}
+
+float noise_fbm_2d(const noise_fbm_t *fbm, float x, float y) {
+    float sum       = 0.0f;
+    float norm      = 0.0f;
+    float amplitude = 1.0f;
+    float frequency = fbm->frequency;
+    for (int o = 0; o < fbm->octaves; ++o) {
+        sum += amplitude * noise_2d(fbm->seed + o, x * frequency, y * frequency);
+        norm += amplitude;
+        amplitude *= fbm->gain;
+        frequency *= fbm->lacunarity;
+    }
+    return sum / norm;
+}
+
+float noise_fbm_3d(const noise_fbm_t *fbm, float x, float y, float z) {
+    float sum       = 0.0f;
+    float norm      = 0.0f;
+    float amplitude = 1.0f;
+    float frequency = fbm->frequency;
+    for (int o = 0; o < fbm->octaves; ++o) {
+        sum += amplitude * noise_3d(fbm->seed + o, x * frequency, y * frequency, z * frequency);
+        norm += amplitude;
+        amplitude *= fbm->gain;
+        frequency *= fbm->lacunarity;
+    }
+    return sum / norm;
+}
+
+static void fbm_2d_plane_scalar(const noise_fbm_t *fbm, float x, float y, float *values) {
+    for (int j = 0; j < NOISE_GRID_SIZE; ++j) {
+        for (int i = 0; i < NOISE_GRID_SIZE; ++i) {
+            values[i + j * NOISE_GRID_SIZE] = noise_fbm_2d(fbm, x + (float)i, y + (float)j);
+        }
+    }
+}
+
+static void fbm_3d_section_scalar(const noise_fbm_t *fbm, float x, float y, float z, float *values) {
+    for (int k = 0; k < NOISE_GRID_SIZE; ++k) {
+        for (int j = 0; j < NOISE_GRID_SIZE; ++j) {
+            for (int i = 0; i < NOISE_GRID_SIZE; ++i) {
+                values[i + j * NOISE_GRID_SIZE + k * NOISE_GRID_SIZE * NOISE_GRID_SIZE] =
+                    noise_fbm_3d(fbm, x + (float)i, y + (float)k, z + (float)j);
+            }
+        }
+    }
+}
+
+#ifdef NOISE_SSE2
+
+// 32-bit lane multiply, SSE2 only multiplies the even lanes into 64-bit products
+static inline __m128i mullo_sse2(__m128i a, __m128i b) {
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static inline __m128 select_sse2(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// Lattice hash of four cells, `yz` is the scalar y and z contribution folded into the seed
+static inline __m128i hash_sse2(uint32_t seed, __m128i x, __m128i y, uint32_t yz) {
+    __m128i h = _mm_xor_si128(_mm_set1_epi32(seed ^ yz), mullo_sse2(x, _mm_set1_epi32(HASH_X)));
+    h         = _mm_xor_si128(h, mullo_sse2(y, _mm_set1_epi32(HASH_Y)));
+    h         = _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+    h         = mullo_sse2(h, _mm_set1_epi32(HASH_MIX_1));
+    h         = _mm_xor_si128(h, _mm_srli_epi32(h, 12));
+    h         = mullo_sse2(h, _mm_set1_epi32(HASH_MIX_2));
+    return _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+}
+
+static inline __m128i floor_sse2(__m128 value) {
+    __m128i i = _mm_cvttps_epi32(value);
+    return _mm_add_epi32(i, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(i), value)));
+}
+
+static inline __m128 fade_sse2(__m128 t) {
+    __m128 t3   = _mm_mul_ps(_mm_mul_ps(t, t), t);
+    __m128 poly = _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f));
+    return _mm_mul_ps(t3, _mm_add_ps(_mm_mul_ps(t, poly), _mm_set1_ps(10.0f)));
+}
+
+static inline __m128 lerp_sse2(__m128 a, __m128 b, __m128 t) { return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a))); }
+
+static inline __m128 negate_if_sse2(__m128 value, __m128i h, int bit) {
+    __m128i sign = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(1 << bit)), 31 - bit);
+    return _mm_xor_ps(value, _mm_castsi128_ps(sign));
+}
+
+static inline __m128 gradient_2d_sse2(__m128i h, __m128 x, __m128 y) {
+    return _mm_add_ps(negate_if_sse2(x, h, 0), negate_if_sse2(y, h, 1));
+}
+
+static inline __m128 gradient_3d_sse2(__m128i h, __m128 x, __m128 y, __m128 z) {
+    __m128i c      = _mm_and_si128(h, _mm_set1_epi32(15));
+    __m128 below_8 = _mm_castsi128_ps(_mm_cmplt_epi32(c, _mm_set1_epi32(8)));
+    __m128 below_4 = _mm_castsi128_ps(_mm_cmplt_epi32(c, _mm_set1_epi32(4)));
+    __m128 use_x   = _mm_castsi128_ps(
+        _mm_or_si128(_mm_cmpeq_epi32(c, _mm_set1_epi32(12)), _mm_cmpeq_epi32(c, _mm_set1_epi32(14))));
+
+    __m128 u = select_sse2(below_8, x, y);
+    __m128 v = select_sse2(below_4, y, select_sse2(use_x, x, z));
+    return _mm_add_ps(negate_if_sse2(u, h, 0), negate_if_sse2(v, h, 1));
+}
+
+static inline __m128 noise_2d_sse2(uint32_t seed, __m128 x, __m128 y) {
+    __m128i xi = floor_sse2(x);
+    __m128i yi = floor_sse2(y);
+    __m128 xf  = _mm_sub_ps(x, _mm_cvtepi32_ps(xi));
+    __m128 yf  = _mm_sub_ps(y, _mm_cvtepi32_ps(yi));
+    __m128i x1 = _mm_add_epi32(xi, _mm_set1_epi32(1));
+    __m128i y1 = _mm_add_epi32(yi, _mm_set1_epi32(1));
+    __m128 xf1 = _mm_sub_ps(xf, _mm_set1_ps(1.0f));
+    __m128 yf1 = _mm_sub_ps(yf, _mm_set1_ps(1.0f));
+
+    __m128 n00 = gradient_2d_sse2(hash_sse2(seed, xi, yi, 0), xf, yf);
+    __m128 n10 = gradient_2d_sse2(hash_sse2(seed, x1, yi, 0), xf1, yf);
+    __m128 n01 = gradient_2d_sse2(hash_sse2(seed, xi, y1, 0), xf, yf1);
+    __m128 n11 = gradient_2d_sse2(hash_sse2(seed, x1, y1, 0), xf1, yf1);
+
+    __m128 u = fade_sse2(xf);
+    __m128 v = fade_sse2(yf);
+    return lerp_sse2(lerp_sse2(n00, n10, u), lerp_sse2(n01, n11, u), v);
+}
+
+// The section kernel varies x across lanes, y and z are shared by every lane and hashed once
+static inline __m128 noise_3d_sse2(uint32_t seed, __m128 x, float y, float z) {
+    int32_t yi = lattice_floor(y);
+    int32_t zi = lattice_floor(z);
+    __m128 yf  = _mm_set1_ps(y - (float)yi);
+    __m128 zf  = _mm_set1_ps(z - (float)zi);
+    __m128 yf1 = _mm_sub_ps(yf, _mm_set1_ps(1.0f));
+    __m128 zf1 = _mm_sub_ps(zf, _mm_set1_ps(1.0f));
+
+    __m128i xi = floor_sse2(x);
+    __m128 xf  = _mm_sub_ps(x, _mm_cvtepi32_ps(xi));
+    __m128i x1 = _mm_add_epi32(xi, _mm_set1_epi32(1));
+    __m128 xf1 = _mm_sub_ps(xf, _mm_set1_ps(1.0f));
+
+    __m128i zero = _mm_setzero_si128();
+    uint32_t y0  = (uint32_t)yi * HASH_Y;
+    uint32_t y1  = (uint32_t)(yi + 1) * HASH_Y;
+    uint32_t z0  = (uint32_t)zi * HASH_Z;
+    uint32_t z1  = (uint32_t)(zi + 1) * HASH_Z;
+
+    __m128 n000 = gradient_3d_sse2(hash_sse2(seed, xi, zero, y0 ^ z0), xf, yf, zf);
+    __m128 n100 = gradient_3d_sse2(hash_sse2(seed, x1, zero, y0 ^ z0), xf1, yf, zf);
+    __m128 n010 = gradient_3d_sse2(hash_sse2(seed, xi, zero, y1 ^ z0), xf, yf1, zf);
+    __m128 n110 = gradient_3d_sse2(hash_sse2(seed, x1, zero, y1 ^ z0), xf1, yf1, zf);
+    __m128 n001 = gradient_3d_sse2(hash_sse2(seed, xi, zero, y0 ^ z1), xf, yf, zf1);
+    __m128 n101 = gradient_3d_sse2(hash_sse2(seed, x1, zero, y0 ^ z1), xf1, yf, zf1);
+    __m128 n011 = gradient_3d_sse2(hash_sse2(seed, xi, zero, y1 ^ z1), xf, yf1, zf1);
+    __m128 n111 = gradient_3d_sse2(hash_sse2(seed, x1, zero, y1 ^ z1), xf1, yf1, zf1);
+
+    __m128 u = fade_sse2(xf);
+    __m128 v = _mm_set1_ps(fade(y - (float)yi));
+    __m128 w = _mm_set1_ps(fade(z - (float)zi));
+    return lerp_sse2(lerp_sse2(lerp_sse2(n000, n100, u), lerp_sse2(n010, n110, u), v),
+                     lerp_sse2(lerp_sse2(n001, n101, u), lerp_sse2(n011, n111, u), v), w);
+}
+
+static void fbm_2d_plane_sse2(const noise_fbm_t *fbm, float x, float y, float *values) {
+    for (int j = 0; j < NOISE_GRID_SIZE; ++j) {
+        __m128 py = _mm_set1_ps(y + (float)j);
+        for (int i = 0; i < NOISE_GRID_SIZE; i += 4) {
+            __m128 px = _mm_add_ps(_mm_set1_ps(x), _mm_setr_ps(i, i + 1, i + 2, i + 3));
+
+            __m128 sum      = _mm_setzero_ps();
+            float norm      = 0.0f;
+            float amplitude = 1.0f;
+            float frequency = fbm->frequency;
+            for (int o = 0; o < fbm->octaves; ++o) {
+                __m128 f     = _mm_set1_ps(frequency);
+                __m128 value = noise_2d_sse2(fbm->seed + o, _mm_mul_ps(px, f), _mm_mul_ps(py, f));
+                sum          = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(amplitude), value));
+                norm += amplitude;
+                amplitude *= fbm->gain;
+                frequency *= fbm->lacunarity;
+            }
+            _mm_storeu_ps(&values[i + j * NOISE_GRID_SIZE], _mm_div_ps(sum, _mm_set1_ps(norm)));
+        }
+    }
+}
+
+static void fbm_3d_section_sse2(const noise_fbm_t *fbm, float x, float y, float z, float *values) {
+    for (int k = 0; k < NOISE_GRID_SIZE; ++k) {
+        float py = y + (float)k;
+        for (int j = 0; j < NOISE_GRID_SIZE; ++j) {
+            float pz = z + (float)j;
+            for (int i = 0; i < NOISE_GRID_SIZE; i += 4) {
+                __m128 px = _mm_add_ps(_mm_set1_ps(x), _mm_setr_ps(i, i + 1, i + 2, i + 3));
+
+                __m128 sum      = _mm_setzero_ps();
+                float norm      = 0.0f;
+                float amplitude = 1.0f;
+                float frequency = fbm->frequency;
+                for (int o = 0; o < fbm->octaves; ++o) {
+                    __m128 f     = _mm_set1_ps(frequency);
+                    __m128 value = noise_3d_sse2(fbm->seed + o, _mm_mul_ps(px, f), py * frequency, pz * frequency);
+                    sum          = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(amplitude), value));
+                    norm += amplitude;
+                    amplitude *= fbm->gain;
+                    frequency *= fbm->lacunarity;
+                }
+                _mm_storeu_ps(&values[i + j * NOISE_GRID_SIZE + k * NOISE_GRID_SIZE * NOISE_GRID_SIZE],
+                              _mm_div_ps(sum, _mm_set1_ps(norm)));
+            }
+        }
+    }
+}
+
+#endif
+
+#ifdef NOISE_AVX2
+
+NOISE_TARGET_AVX2 static inline __m256i hash_avx2(uint32_t seed, __m256i x, __m256i y, uint32_t yz) {
+    __m256i h = _mm256_xor_si256(_mm256_set1_epi32(seed ^ yz), _mm256_mullo_epi32(x, _mm256_set1_epi32(HASH_X)));
+    h         = _mm256_xor_si256(h, _mm256_mullo_epi32(y, _mm256_set1_epi32(HASH_Y)));
+    h         = _mm256_xor_si256(h, _mm256_srli_epi32(h, 15));
+    h         = _mm256_mullo_epi32(h, _mm256_set1_epi32(HASH_MIX_1));
+    h         = _mm256_xor_si256(h, _mm256_srli_epi32(h, 12));
+    h         = _mm256_mullo_epi32(h, _mm256_set1_epi32(HASH_MIX_2));
+    return _mm256_xor_si256(h, _mm256_srli_epi32(h, 15));
+}
+
+NOISE_TARGET_AVX2 static inline __m256i floor_avx2(__m256 value) {
+    __m256i i = _mm256_cvttps_epi32(value);
+    return _mm256_add_epi32(i, _mm256_castps_si256(_mm256_cmp_ps(_mm256_cvtepi32_ps(i), value, _CMP_GT_OQ)));
+}
+
+NOISE_TARGET_AVX2 static inline __m256 fade_avx2(__m256 t) {
+    __m256 t3   = _mm256_mul_ps(_mm256_mul_ps(t, t), t);
+    __m256 poly = _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f));
+    return _mm256_mul_ps(t3, _mm256_add_ps(_mm256_mul_ps(t, poly), _mm256_set1_ps(10.0f)));
+}
+
+NOISE_TARGET_AVX2 static inline __m256 lerp_avx2(__m256 a, __m256 b, __m256 t) {
+    return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+}
+
+NOISE_TARGET_AVX2 static inline __m256 negate_if_avx2(__m256 value, __m256i h, int bit) {
+    __m256i sign = _mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(1 << bit)), 31 - bit);
+    return _mm256_xor_ps(value, _mm256_castsi256_ps(sign));
+}
+
+NOISE_TARGET_AVX2 static inline __m256 gradient_2d_avx2(__m256i h, __m256 x, __m256 y) {
+    return _mm256_add_ps(negate_if_avx2(x, h, 0), negate_if_avx2(y, h, 1));
+}
+
+NOISE_TARGET_AVX2 static inline __m256 gradient_3d_avx2(__m256i h, __m256 x, __m256 y, __m256 z) {
+    __m256i c      = _mm256_and_si256(h, _mm256_set1_epi32(15));
+    __m256 below_8 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(8), c));
+    __m256 below_4 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(4), c));
+    __m256 use_x   = _mm256_castsi256_ps(
+        _mm256_or_si256(_mm256_cmpeq_epi32(c, _mm256_set1_epi32(12)), _mm256_cmpeq_epi32(c, _mm256_set1_epi32(14))));
+
+    __m256 u = _mm256_blendv_ps(y, x, below_8);
+    __m256 v = _mm256_blendv_ps(_mm256_blendv_ps(z, x, use_x), y, below_4);
+    return _mm256_add_ps(negate_if_avx2(u, h, 0), negate_if_avx2(v, h, 1));
+}
+
+NOISE_TARGET_AVX2 static inline __m256 noise_2d_avx2(uint32_t seed, __m256 x, __m256 y) {
+    __m256i xi = floor_avx2(x);
+    __m256i yi = floor_avx2(y);
+    __m256 xf  = _mm256_sub_ps(x, _mm256_cvtepi32_ps(xi));
+    __m256 yf  = _mm256_sub_ps(y, _mm256_cvtepi32_ps(yi));
+    __m256i x1 = _mm256_add_epi32(xi, _mm256_set1_epi32(1));
+    __m256i y1 = _mm256_add_epi32(yi, _mm256_set1_epi32(1));
+    __m256 xf1 = _mm256_sub_ps(xf, _mm256_set1_ps(1.0f));
+    __m256 yf1 = _mm256_sub_ps(yf, _mm256_set1_ps(1.0f));
+
+    __m256 n00 = gradient_2d_avx2(hash_avx2(seed, xi, yi, 0), xf, yf);
+    __m256 n10 = gradient_2d_avx2(hash_avx2(seed, x1, yi, 0), xf1, yf);
+    __m256 n01 = gradient_2d_avx2(hash_avx2(seed, xi, y1, 0), xf, yf1);
+    __m256 n11 = gradient_2d_avx2(hash_avx2(seed, x1, y1, 0), xf1, yf1);
+
+    __m256 u = fade_avx2(xf);
+    __m256 v = fade_avx2(yf);
+    return lerp_avx2(lerp_avx2(n00, n10, u), lerp_avx2(n01, n11, u), v);
+}
+
+NOISE_TARGET_AVX2 static inline __m256 noise_3d_avx2(uint32_t seed, __m256 x, float y, float z) {
+    int32_t yi = lattice_floor(y);
+    int32_t zi = lattice_floor(z);
+    __m256 yf  = _mm256_set1_ps(y - (float)yi);
+    __m256 zf  = _mm256_set1_ps(z - (float)zi);
+    __m256 yf1 = _mm256_sub_ps(yf, _mm256_set1_ps(1.0f));
+    __m256 zf1 = _mm256_sub_ps(zf, _mm256_set1_ps(1.0f));
+
+    __m256i xi = floor_avx2(x);
+    __m256 xf  = _mm256_sub_ps(x, _mm256_cvtepi32_ps(xi));
+    __m256i x1 = _mm256_add_epi32(xi, _mm256_set1_epi32(1));
+    __m256 xf1 = _mm256_sub_ps(xf, _mm256_set1_ps(1.0f));
+
+    __m256i zero = _mm256_setzero_si256();
+    uint32_t y0  = (uint32_t)yi * HASH_Y;
+    uint32_t y1  = (uint32_t)(yi + 1) * HASH_Y;
+    uint32_t z0  = (uint32_t)zi * HASH_Z;
+    uint32_t z1  = (uint32_t)(zi + 1) * HASH_Z;
+
+    __m256 n000 = gradient_3d_avx2(hash_avx2(seed, xi, zero, y0 ^ z0), xf, yf, zf);
+    __m256 n100 = gradient_3d_avx2(hash_avx2(seed, x1, zero, y0 ^ z0), xf1, yf, zf);
+    __m256 n010 = gradient_3d_avx2(hash_avx2(seed, xi, zero, y1 ^ z0), xf, yf1, zf);
+    __m256 n110 = gradient_3d_avx2(hash_avx2(seed, x1, zero, y1 ^ z0), xf1, yf1, zf);
+    __m256 n001 = gradient_3d_avx2(hash_avx2(seed, xi, zero, y0 ^ z1), xf, yf, zf1);
+    __m256 n101 = gradient_3d_avx2(hash_avx2(seed, x1, zero, y0 ^ z1), xf1, yf, zf1);
+    __m256 n011 = gradient_3d_avx2(hash_avx2(seed, xi, zero, y1 ^ z1), xf, yf1, zf1);
+    __m256 n111 = gradient_3d_avx2(hash_avx2(seed, x1, zero, y1 ^ z1), xf1, yf1, zf1);
+
+    __m256 u = fade_avx2(xf);
+    __m256 v = _mm256_set1_ps(fade(y - (float)yi));
+    __m256 w = _mm256_set1_ps(fade(z - (float)zi));
+    return lerp_avx2(lerp_avx2(lerp_avx2(n000, n100, u), lerp_avx2(n010, n110, u), v),
+                     lerp_avx2(lerp_avx2(n001, n101, u), lerp_avx2(n011, n111, u), v), w);
+}
+
+NOISE_TARGET_AVX2 static void fbm_2d_plane_avx2(const noise_fbm_t *fbm, float x, float y, float *values) {
+    for (int j = 0; j < NOISE_GRID_SIZE; ++j) {
+        __m256 py = _mm256_set1_ps(y + (float)j);
+        for (int i = 0; i < NOISE_GRID_SIZE; i += 8) {
+            __m256 px =
+                _mm256_add_ps(_mm256_set1_ps(x), _mm256_setr_ps(i, i + 1, i + 2, i + 3, i + 4, i + 5, i + 6, i + 7));
+
+            __m256 sum      = _mm256_setzero_ps();
+            float norm      = 0.0f;
+            float amplitude = 1.0f;
+            float frequency = fbm->frequency;
+            for (int o = 0; o < fbm->octaves; ++o) {
+                __m256 f     = _mm256_set1_ps(frequency);
+                __m256 value = noise_2d_avx2(fbm->seed + o, _mm256_mul_ps(px, f), _mm256_mul_ps(py, f));
+                sum          = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(amplitude), value));
+                norm += amplitude;
+                amplitude *= fbm->gain;
+                frequency *= fbm->lacunarity;
+            }
+            _mm256_storeu_ps(&values[i + j * NOISE_GRID_SIZE], _mm256_div_ps(sum, _mm256_set1_ps(norm)));
+        }
+    }
+}
+
+NOISE_TARGET_AVX2 static void fbm_3d_section_avx2(const noise_fbm_t *fbm, float x, float y, float z, float *values) {
+    for (int k = 0; k < NOISE_GRID_SIZE; ++k) {
+        float py = y + (float)k;
+        for (int j = 0; j < NOISE_GRID_SIZE; ++j) {
+            float pz = z + (float)j;
+            for (int i = 0; i < NOISE_GRID_SIZE; i += 8) {
+                __m256 px = _mm256_add_ps(_mm256_set1_ps(x),
+                                          _mm256_setr_ps(i, i + 1, i + 2, i + 3, i + 4, i + 5, i + 6, i + 7));
+
+                __m256 sum      = _mm256_setzero_ps();
+                float norm      = 0.0f;
+                float amplitude = 1.0f;
+                float frequency = fbm->frequency;
+                for (int o = 0; o < fbm->octaves; ++o) {
+                    __m256 f     = _mm256_set1_ps(frequency);
+                    __m256 value = noise_3d_avx2(fbm->seed + o, _mm256_mul_ps(px, f), py * frequency, pz * frequency);
+                    sum          = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(amplitude), value));
+                    norm += amplitude;
+                    amplitude *= fbm->gain;
+                    frequency *= fbm->lacunarity;
+                }
+                _mm256_storeu_ps(&values[i + j * NOISE_GRID_SIZE + k * NOISE_GRID_SIZE * NOISE_GRID_SIZE],
+                                 _mm256_div_ps(sum, _mm256_set1_ps(norm)));
+            }
+        }
+    }
+}
+
+#endif
+
+static noise_kernel_t supported_kernel() {
+#ifdef NOISE_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        return NOISE_KERNEL_AVX2;
+    }
+#endif
+#ifdef NOISE_SSE2
+    return NOISE_KERNEL_SSE2;
+#else
+    return NOISE_KERNEL_SCALAR;
+#endif
+}
+
+noise_kernel_t noise_get_kernel() {
+    noise_kernel_t supported = supported_kernel();
+    if (kernel_override >= 0 && kernel_override < (int)supported) {
+        return (noise_kernel_t)kernel_override;
+    }
+    return supported;
+}
+
+void noise_set_kernel(noise_kernel_t kernel) {
+    if (kernel > supported_kernel()) {
+        LOG_WARN("Noise kernel %d is not supported, using kernel %d", kernel, supported_kernel());
+    }
+    kernel_override = (int)kernel;
+}
+
+void noise_fbm_2d_plane(const noise_fbm_t *fbm, float x, float y, float *values) {
+    if (fbm == NULL) {
+        LOG_ERROR("'noise_fbm_2d_plane' called with NULL fbm");
+        return;
+    }
+
+    switch (noise_get_kernel()) {
+#ifdef NOISE_AVX2
+        case NOISE_KERNEL_AVX2:
+            fbm_2d_plane_avx2(fbm, x, y, values);
+            return;
+#endif
+#ifdef NOISE_SSE2
+        case NOISE_KERNEL_SSE2:
+            fbm_2d_plane_sse2(fbm, x, y, values);
+            return;
+#endif
+        default:
+            fbm_2d_plane_scalar(fbm, x, y, values);
+            return;
+    }
+}
+
+void noise_fbm_3d_section(const noise_fbm_t *fbm, float x, float y, float z, float *values) {
+    if (fbm == NULL) {
+        LOG_ERROR("'noise_fbm_3d_section' called with NULL fbm");
+        return;
+    }
+
+    switch (noise_get_kernel()) {
+#ifdef NOISE_AVX2
+        case NOISE_KERNEL_AVX2:
+            fbm_3d_section_avx2(fbm, x, y, z, values);
+            return;
+#endif
+#ifdef NOISE_SSE2
+        case NOISE_KERNEL_SSE2:
+            fbm_3d_section_sse2(fbm, x, y, z, values);
+            return;
+#endif
+        default:
+            fbm_3d_section_scalar(fbm, x, y, z, values);
+            return;
+    }
+}
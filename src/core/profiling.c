@@ -9,9 +9,24 @@
 #include "core/log.h"
 
 #ifdef PROFILING_ENABLED
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+
+static long page_fault_count() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return usage.ru_minflt + usage.ru_majflt;
+}
+#else
+static long page_fault_count() { return 0; }
+#endif
+
 typedef struct {
     int id;
     clock_t start_time;
+    long start_page_faults;
     char description[256];
 } profile_t;
 
@@ -56,8 +71,9 @@ int profiling_begin(const char *format, ...) {
     vsnprintf(profiles[profile_count].description, sizeof(profiles[profile_count].description), format, args);
     va_end(args);
 
-    profiles[profile_count].id         = profile_count;
-    profiles[profile_count].start_time = clock();
+    profiles[profile_count].id                = profile_count;
+    profiles[profile_count].start_time        = clock();
+    profiles[profile_count].start_page_faults = page_fault_count();
     ++profile_count;
 
     if (profile_count >= profile_capacity) {
@@ -76,8 +92,10 @@ void profiling_end(int id) {
 
     clock_t end_time    = clock();
     double elapsed_time = ((double)(end_time - profiles[id].start_time)) / CLOCKS_PER_SEC;
+    long page_faults    = page_fault_count() - profiles[id].start_page_faults;
 
-    LOG_DEBUG("Profile [%d]: %s - Elapsed time: %.6f seconds", id, profiles[id].description, elapsed_time);
+    LOG_DEBUG("Profile [%d]: %s - Elapsed time: %.6f seconds, page faults: %ld", id, profiles[id].description,
+              elapsed_time, page_faults);
 
     profile_delete(id);
 }
@@ -5,6 +5,7 @@
 #include <glad/glad.h>
 
 #include "core/log.h"
+#include "graphics/gl_state.h"
 
 const char* buffer_target_to_string(buffer_target_t target) {
     switch (target) {
@@ -15,6 +16,12 @@ const char* buffer_target_to_string(buffer_target_t target) {
     }
 }
 
+// Element array bindings are vertex array state, uploads go through the array target so they never change the
+// element buffer of the bound vertex array
+static buffer_target_t upload_target(buffer_target_t target) {
+    return target == BUFFER_TARGET_ELEMENT_ARRAY_BUFFER ? BUFFER_TARGET_ARRAY_BUFFER : target;
+}
+
 uint32_t buffer_create(size_t size, const void *data, buffer_usage_t usage, buffer_target_t target) {
     uint32_t buffer;
 
@@ -38,6 +45,7 @@ void buffer_destroy(uint32_t *buffer) {
     }
 
     LOG_TRACE("Deleting buffer with ID: %d", *buffer);
+    gl_state_forget_buffer(*buffer);
     glDeleteBuffers(1, buffer);
 }
 
@@ -47,16 +55,17 @@ void buffer_bind(uint32_t buffer, buffer_target_t target) {
         return;
     }
 
-    glBindBuffer(target, buffer);
+    gl_state_bind_buffer(target, buffer);
 }
 
-void buffer_bind_range(uint32_t buffer, buffer_target_t target, const uint32_t binding_point, size_t size) {
+void buffer_bind_range(uint32_t buffer, buffer_target_t target, const uint32_t binding_point, size_t offset,
+                       size_t size) {
     if (buffer == 0) {
         LOG_WARN("'buffer_bind_range' called with 0 buffer");
         return;
     }
 
-    glBindBufferRange(target, binding_point, buffer, 0, size);
+    gl_state_bind_buffer_range(target, binding_point, buffer, offset, size);
 }
 
 void buffer_bind_base(uint32_t buffer, buffer_target_t target, const uint32_t binding_point) {
@@ -65,12 +74,10 @@ void buffer_bind_base(uint32_t buffer, buffer_target_t target, const uint32_t bi
         return;
     }
 
-    glBindBufferBase(target, binding_point, buffer);
+    gl_state_bind_buffer_range(target, binding_point, buffer, 0, 0);
 }
 
-void buffer_unbind(buffer_target_t target) {
-    glBindBuffer(target, 0);
-}
+void buffer_unbind(buffer_target_t target) { gl_state_bind_buffer(target, 0); }
 
 void buffer_data(uint32_t buffer, buffer_target_t target, size_t size, const void *data, buffer_usage_t usage) {
     if (buffer == 0) {
@@ -78,6 +85,7 @@ void buffer_data(uint32_t buffer, buffer_target_t target, size_t size, const voi
         return;
     }
 
+    target = upload_target(target);
     buffer_bind(buffer, target);
     glBufferData(target, size, data, usage);
     buffer_unbind(target);
@@ -89,7 +97,54 @@ void buffer_sub_data(uint32_t buffer, buffer_target_t target, size_t offset, siz
         return;
     }
 
+    target = upload_target(target);
     buffer_bind(buffer, target);
     glBufferSubData(target, offset, size, data);
     buffer_unbind(target);
 }
+
+void buffer_copy_sub_data(uint32_t source, uint32_t destination, size_t source_offset, size_t destination_offset,
+                          size_t size) {
+    if (source == 0 || destination == 0) {
+        LOG_WARN("'buffer_copy_sub_data' called with 0 buffer");
+        return;
+    }
+
+    buffer_bind(source, BUFFER_TARGET_COPY_READ_BUFFER);
+    buffer_bind(destination, BUFFER_TARGET_COPY_WRITE_BUFFER);
+    glCopyBufferSubData(BUFFER_TARGET_COPY_READ_BUFFER, BUFFER_TARGET_COPY_WRITE_BUFFER, source_offset,
+                        destination_offset, size);
+    buffer_unbind(BUFFER_TARGET_COPY_READ_BUFFER);
+    buffer_unbind(BUFFER_TARGET_COPY_WRITE_BUFFER);
+}
+
+void *buffer_map_range(uint32_t buffer, buffer_target_t target, size_t offset, size_t size, uint32_t access) {
+    if (buffer == 0) {
+        LOG_WARN("'buffer_map_range' called with 0 buffer");
+        return NULL;
+    }
+
+    target = upload_target(target);
+    buffer_bind(buffer, target);
+    void *data = glMapBufferRange(target, offset, size, access);
+    buffer_unbind(target);
+
+    if (data == NULL) {
+        LOG_ERROR("Failed to map %zu bytes of %s with ID: %d", size, buffer_target_to_string(target), buffer);
+    }
+    return data;
+}
+
+int buffer_unmap(uint32_t buffer, buffer_target_t target) {
+    if (buffer == 0) {
+        LOG_WARN("'buffer_unmap' called with 0 buffer");
+        return -1;
+    }
+
+    target = upload_target(target);
+    buffer_bind(buffer, target);
+    GLboolean result = glUnmapBuffer(target);
+    buffer_unbind(target);
+
+    return result == GL_TRUE ? 0 : -1;
+}
@@ -21,6 +21,8 @@ struct camera {
 
     mat4s view;
     int view_dirty;
+
+    mat4s projection;
 };
 
 static vec3s world_up = (vec3s){{0.0f, 1.0f, 0.0f}};
@@ -87,6 +89,7 @@ camera_t *camera_create(camera_settings_t settings) {
     camera->pitch = 0.0f;
     camera->fov = settings.fov;
     camera->sensitivity = settings.sensitivity;
+    camera->projection = glms_mat4_identity();
 
     // Initialize front, up, and right vectors
     camera->front = (vec3s){{0.0f, 0.0f, -1.0f}};
@@ -206,3 +209,27 @@ void camera_translate(camera_t *camera, vec3s translation) {
         update_view(camera);
     }
 }
+
+void camera_set_projection(camera_t *camera, mat4s projection) {
+    if (camera == NULL) {
+        LOG_ERROR("'camera_set_projection' called with NULL camera");
+        return;
+    }
+    camera->projection = projection;
+}
+
+mat4s camera_get_projection(camera_t *camera) {
+    if (camera == NULL) {
+        LOG_ERROR("'camera_get_projection' called with NULL camera");
+        return GLMS_MAT4_ZERO;
+    }
+    return camera->projection;
+}
+
+frustum_t camera_get_frustum(camera_t *camera) {
+    if (camera == NULL) {
+        LOG_ERROR("'camera_get_frustum' called with NULL camera");
+        return (frustum_t){0};
+    }
+    return frustum_from_matrix(glms_mat4_mul(camera->projection, camera->view));
+}
@@ -0,0 +1,54 @@
+#include "graphics/fence.h"
+
+#include <stdlib.h>
+
+#include <glad/glad.h>
+
+#include "core/log.h"
+
+fence_t fence_create() {
+    GLsync sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    if (sync == NULL) {
+        LOG_ERROR("Failed to create fence");
+    }
+    return sync;
+}
+
+void fence_destroy(fence_t *fence) {
+    if (fence == NULL) {
+        LOG_ERROR("'fence_destroy' called with NULL fence");
+        return;
+    }
+
+    if (*fence == NULL) {
+        return;
+    }
+
+    glDeleteSync(*fence);
+    *fence = NULL;
+}
+
+int fence_signaled(fence_t fence) {
+    if (fence == NULL) {
+        LOG_ERROR("'fence_signaled' called with NULL fence");
+        return 0;
+    }
+
+    GLint status = GL_UNSIGNALED;
+    glGetSynciv(fence, GL_SYNC_STATUS, 1, NULL, &status);
+    return status == GL_SIGNALED;
+}
+
+int fence_wait(fence_t fence, uint64_t timeout) {
+    if (fence == NULL) {
+        LOG_ERROR("'fence_wait' called with NULL fence");
+        return -1;
+    }
+
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+    if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) {
+        LOG_WARN("Fence wait %s", result == GL_TIMEOUT_EXPIRED ? "timed out" : "failed");
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include "graphics/frustum.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/log.h"
+
+#define AABB_LIST_BASE_CAPACITY 256
+
+// Float arrays making up a box list, laid out back to back in a single allocation
+#define AABB_LIST_ARRAYS 6
+
+frustum_t frustum_from_matrix(mat4s view_projection) {
+    // Gribb-Hartmann: every plane is the last row of the matrix plus or minus one of the others. cglm matrices are
+    // column major, so row `r` is `raw[0][r], raw[1][r], raw[2][r], raw[3][r]`.
+    static const int rows[FRUSTUM_PLANE_COUNT]    = {0, 0, 1, 1, 2, 2};
+    static const float signs[FRUSTUM_PLANE_COUNT] = {1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f};
+
+    frustum_t frustum;
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; ++p) {
+        vec4s plane;
+        for (int c = 0; c < 4; ++c) {
+            plane.raw[c] = view_projection.raw[c][3] + signs[p] * view_projection.raw[c][rows[p]];
+        }
+
+        float length = sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (length > 0.0f) {
+            for (int c = 0; c < 4; ++c) {
+                plane.raw[c] /= length;
+            }
+        }
+        frustum.planes[p] = plane;
+    }
+    return frustum;
+}
+
+void frustum_cull_aabbs(const frustum_t *frustum, aabb_list_t *boxes) {
+    if (frustum == NULL) {
+        LOG_ERROR("'frustum_cull_aabbs' called with NULL frustum");
+        return;
+    }
+
+    if (boxes == NULL) {
+        LOG_ERROR("'frustum_cull_aabbs' called with NULL boxes");
+        return;
+    }
+
+    size_t count = boxes->count;
+    memset(boxes->visible, 1, count);
+
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; ++p) {
+        vec4s plane = frustum->planes[p];
+
+        // The corner furthest along the normal is the same for every box, pick its arrays once so the loop below is
+        // a branch free multiply-add over contiguous floats
+        const float *restrict xs  = plane.x >= 0.0f ? boxes->max_x : boxes->min_x;
+        const float *restrict ys  = plane.y >= 0.0f ? boxes->max_y : boxes->min_y;
+        const float *restrict zs  = plane.z >= 0.0f ? boxes->max_z : boxes->min_z;
+        uint8_t *restrict visible = boxes->visible;
+
+        for (size_t i = 0; i < count; ++i) {
+            float distance = plane.x * xs[i] + plane.y * ys[i] + plane.z * zs[i] + plane.w;
+            visible[i] &= distance >= 0.0f;
+        }
+    }
+}
+
+static int aabb_list_reserve(aabb_list_t *boxes, size_t capacity) {
+    float *floats    = malloc(capacity * AABB_LIST_ARRAYS * sizeof(float));
+    uint8_t *visible = malloc(capacity);
+    if (floats == NULL || visible == NULL) {
+        LOG_ERROR("Failed to allocate box list");
+        free(floats);
+        free(visible);
+        return -1;
+    }
+
+    float **arrays[AABB_LIST_ARRAYS] = {&boxes->min_x, &boxes->min_y, &boxes->min_z,
+                                        &boxes->max_x, &boxes->max_y, &boxes->max_z};
+    for (int a = 0; a < AABB_LIST_ARRAYS; ++a) {
+        if (boxes->count > 0) {
+            memcpy(floats + a * capacity, *arrays[a], boxes->count * sizeof(float));
+        }
+    }
+
+    // The first array owns the allocation
+    free(boxes->min_x);
+    free(boxes->visible);
+    for (int a = 0; a < AABB_LIST_ARRAYS; ++a) {
+        *arrays[a] = floats + a * capacity;
+    }
+    boxes->visible  = visible;
+    boxes->capacity = capacity;
+    return 0;
+}
+
+int aabb_list_init(aabb_list_t *boxes, size_t capacity) {
+    if (boxes == NULL) {
+        LOG_ERROR("'aabb_list_init' called with NULL boxes");
+        return -1;
+    }
+
+    memset(boxes, 0, sizeof(aabb_list_t));
+    return aabb_list_reserve(boxes, capacity > 0 ? capacity : AABB_LIST_BASE_CAPACITY);
+}
+
+void aabb_list_free(aabb_list_t *boxes) {
+    if (boxes == NULL) {
+        LOG_ERROR("'aabb_list_free' called with NULL boxes");
+        return;
+    }
+
+    free(boxes->min_x);
+    free(boxes->visible);
+    memset(boxes, 0, sizeof(aabb_list_t));
+}
+
+int aabb_list_push(aabb_list_t *boxes, vec3s min, vec3s max) {
+    if (boxes->count == boxes->capacity &&
+        aabb_list_reserve(boxes, boxes->capacity ? boxes->capacity * 2 : AABB_LIST_BASE_CAPACITY) != 0) {
+        return -1;
+    }
+
+    size_t i        = boxes->count++;
+    boxes->min_x[i] = min.x;
+    boxes->min_y[i] = min.y;
+    boxes->min_z[i] = min.z;
+    boxes->max_x[i] = max.x;
+    boxes->max_y[i] = max.y;
+    boxes->max_z[i] = max.z;
+    return 0;
+}
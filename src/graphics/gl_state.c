@@ -0,0 +1,235 @@
+#include "graphics/gl_state.h"
+
+#include <glad/glad.h>
+
+// Cached value that may not match the context, the next call is always issued
+#define GL_STATE_UNKNOWN UINT32_MAX
+
+#define GL_STATE_TEXTURE_UNITS    16
+#define GL_STATE_UNIFORM_BINDINGS 16
+#define GL_STATE_PROGRAMS         16
+#define GL_STATE_UNIFORM_BLOCKS   16
+
+enum buffer_slot {
+    BUFFER_SLOT_ARRAY,
+    BUFFER_SLOT_ELEMENT_ARRAY,
+    BUFFER_SLOT_UNIFORM,
+    BUFFER_SLOT_COPY_READ,
+    BUFFER_SLOT_COPY_WRITE,
+    BUFFER_SLOT_TEXTURE,
+    BUFFER_SLOT_COUNT,
+};
+
+enum texture_slot {
+    TEXTURE_SLOT_2D,
+    TEXTURE_SLOT_BUFFER,
+    TEXTURE_SLOT_COUNT,
+};
+
+typedef struct {
+    uint32_t buffer;
+    size_t offset;
+    size_t size;
+} indexed_binding_t;
+
+// Uniform block binding points of a program, they are program state and survive switching programs
+typedef struct {
+    uint32_t program;
+    uint32_t bindings[GL_STATE_UNIFORM_BLOCKS];
+} program_blocks_t;
+
+// Zero initialized, which matches the defaults of a fresh context
+static struct {
+    uint32_t program;
+    uint32_t vertex_array;
+    uint32_t buffers[BUFFER_SLOT_COUNT];
+    indexed_binding_t uniform_bindings[GL_STATE_UNIFORM_BINDINGS];
+
+    uint32_t active_texture;
+    uint32_t textures[GL_STATE_TEXTURE_UNITS][TEXTURE_SLOT_COUNT];
+
+    program_blocks_t programs[GL_STATE_PROGRAMS];
+    size_t program_count;
+
+    gl_state_counters_t counters;
+} state;
+
+static int buffer_slot(uint32_t target) {
+    switch (target) {
+        case GL_ARRAY_BUFFER:
+            return BUFFER_SLOT_ARRAY;
+        case GL_ELEMENT_ARRAY_BUFFER:
+            return BUFFER_SLOT_ELEMENT_ARRAY;
+        case GL_UNIFORM_BUFFER:
+            return BUFFER_SLOT_UNIFORM;
+        case GL_COPY_READ_BUFFER:
+            return BUFFER_SLOT_COPY_READ;
+        case GL_COPY_WRITE_BUFFER:
+            return BUFFER_SLOT_COPY_WRITE;
+        case GL_TEXTURE_BUFFER:
+            return BUFFER_SLOT_TEXTURE;
+        default:
+            return -1;
+    }
+}
+
+static int texture_slot(uint32_t target) {
+    switch (target) {
+        case GL_TEXTURE_2D:
+            return TEXTURE_SLOT_2D;
+        case GL_TEXTURE_BUFFER:
+            return TEXTURE_SLOT_BUFFER;
+        default:
+            return -1;
+    }
+}
+
+// Updates a cached value, returns non-zero if the call has to be issued
+static int update(uint32_t *cached, uint32_t value) {
+    if (cached != NULL && *cached == value) {
+        ++state.counters.skipped;
+        return 0;
+    }
+
+    if (cached != NULL) {
+        *cached = value;
+    }
+    ++state.counters.issued;
+    return 1;
+}
+
+void gl_state_use_program(uint32_t program) {
+    if (update(&state.program, program)) {
+        glUseProgram(program);
+    }
+}
+
+void gl_state_bind_vertex_array(uint32_t vertex_array) {
+    if (update(&state.vertex_array, vertex_array)) {
+        glBindVertexArray(vertex_array);
+        state.buffers[BUFFER_SLOT_ELEMENT_ARRAY] = GL_STATE_UNKNOWN;
+    }
+}
+
+void gl_state_bind_buffer(uint32_t target, uint32_t buffer) {
+    int slot = buffer_slot(target);
+    if (update(slot >= 0 ? &state.buffers[slot] : NULL, buffer)) {
+        glBindBuffer(target, buffer);
+    }
+}
+
+void gl_state_bind_buffer_range(uint32_t target, uint32_t index, uint32_t buffer, size_t offset, size_t size) {
+    indexed_binding_t *binding = NULL;
+    if (target == GL_UNIFORM_BUFFER && index < GL_STATE_UNIFORM_BINDINGS) {
+        binding = &state.uniform_bindings[index];
+    }
+
+    if (binding && binding->buffer == buffer && binding->offset == offset && binding->size == size) {
+        ++state.counters.skipped;
+        return;
+    }
+
+    if (size == 0) {
+        glBindBufferBase(target, index, buffer);
+    } else {
+        glBindBufferRange(target, index, buffer, offset, size);
+    }
+    ++state.counters.issued;
+
+    if (binding) {
+        *binding = (indexed_binding_t) {buffer, offset, size};
+    }
+
+    // Indexed binds bind the generic target as well
+    int slot = buffer_slot(target);
+    if (slot >= 0) {
+        state.buffers[slot] = buffer;
+    }
+}
+
+void gl_state_active_texture(uint32_t slot) {
+    if (update(&state.active_texture, slot)) {
+        glActiveTexture(GL_TEXTURE0 + slot);
+    }
+}
+
+void gl_state_bind_texture(uint32_t target, uint32_t texture) {
+    int slot      = texture_slot(target);
+    uint32_t unit = state.active_texture;
+    if (update(slot >= 0 && unit < GL_STATE_TEXTURE_UNITS ? &state.textures[unit][slot] : NULL, texture)) {
+        glBindTexture(target, texture);
+    }
+}
+
+void gl_state_uniform_block_binding(uint32_t program, uint32_t block_index, uint32_t binding_point) {
+    program_blocks_t *blocks = NULL;
+    for (size_t i = 0; i < state.program_count && blocks == NULL; ++i) {
+        if (state.programs[i].program == program) {
+            blocks = &state.programs[i];
+        }
+    }
+
+    // Blocks of a freshly linked program all read from binding point zero
+    if (blocks == NULL && state.program_count < GL_STATE_PROGRAMS) {
+        blocks          = &state.programs[state.program_count++];
+        *blocks         = (program_blocks_t) {0};
+        blocks->program = program;
+    }
+
+    uint32_t *cached = blocks && block_index < GL_STATE_UNIFORM_BLOCKS ? &blocks->bindings[block_index] : NULL;
+    if (update(cached, binding_point)) {
+        glUniformBlockBinding(program, block_index, binding_point);
+    }
+}
+
+void gl_state_forget_program(uint32_t program) {
+    // A deleted program stays in use until another one replaces it, and its ID may be handed out again meanwhile
+    if (state.program == program) {
+        state.program = GL_STATE_UNKNOWN;
+    }
+
+    for (size_t i = 0; i < state.program_count; ++i) {
+        if (state.programs[i].program == program) {
+            state.programs[i] = state.programs[--state.program_count];
+            break;
+        }
+    }
+}
+
+void gl_state_forget_vertex_array(uint32_t vertex_array) {
+    if (state.vertex_array == vertex_array) {
+        state.vertex_array                       = 0;
+        state.buffers[BUFFER_SLOT_ELEMENT_ARRAY] = GL_STATE_UNKNOWN;
+    }
+}
+
+void gl_state_forget_buffer(uint32_t buffer) {
+    for (int i = 0; i < BUFFER_SLOT_COUNT; ++i) {
+        if (state.buffers[i] == buffer) {
+            state.buffers[i] = 0;
+        }
+    }
+
+    for (int i = 0; i < GL_STATE_UNIFORM_BINDINGS; ++i) {
+        if (state.uniform_bindings[i].buffer == buffer) {
+            state.uniform_bindings[i] = (indexed_binding_t) {0, 0, 0};
+        }
+    }
+}
+
+void gl_state_forget_texture(uint32_t texture) {
+    for (int unit = 0; unit < GL_STATE_TEXTURE_UNITS; ++unit) {
+        for (int i = 0; i < TEXTURE_SLOT_COUNT; ++i) {
+            if (state.textures[unit][i] == texture) {
+                state.textures[unit][i] = 0;
+            }
+        }
+    }
+}
+
+gl_state_counters_t gl_state_get_counters() { return state.counters; }
+
+void gl_state_reset_counters() {
+    state.counters.issued  = 0;
+    state.counters.skipped = 0;
+}
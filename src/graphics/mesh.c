@@ -1,5 +1,7 @@
 #include "graphics/mesh.h"
 
+#include <stdlib.h>
+
 #include "core/log.h"
 #include "graphics/buffer.h"
 #include "graphics/renderer.h"
@@ -7,34 +9,102 @@
 #include "graphics/vertex_array.h"
 
 struct mesh_private_data {
+    vertex_layout_t layout;
+
     size_t vertex_count;
     size_t index_count;
 
+    // Quad meshes draw through the shared quad index buffer instead of their own index buffer
+    int quads;
+
     uint32_t vertex_array;
     uint32_t vertex_buffer;
     uint32_t index_buffer;
 };
 
-mesh_t *mesh_create(vertex_t *vertices, size_t vertex_count, uint32_t *indices, size_t index_count,
-                    shader_program_t *shader_program, uint32_t texture) {
+static const vertex_layout_t default_layout = VERTEX_LAYOUT_DEFAULT_INIT;
+
+// Shared 0, 1, 2, 2, 3, 0 quad index pattern, grown on demand and referenced by every quad mesh
+static uint32_t quad_index_buffer = 0;
+static size_t quad_index_capacity = 0;
+
+#define QUAD_INDEX_MIN_CAPACITY 4096
+
+uint32_t mesh_quad_indices_reserve(size_t quad_count) {
+    if (quad_index_buffer != 0 && quad_count <= quad_index_capacity) {
+        return quad_index_buffer;
+    }
+
+    size_t capacity = quad_index_capacity ? quad_index_capacity : QUAD_INDEX_MIN_CAPACITY;
+    while (capacity < quad_count) {
+        capacity *= 2;
+    }
+
+    uint32_t *indices = malloc(capacity * 6 * sizeof(uint32_t));
+    if (indices == NULL) {
+        LOG_ERROR("Failed to allocate quad indices");
+        return 0;
+    }
+
+    for (size_t i = 0; i < capacity; ++i) {
+        uint32_t vertex    = i * 4;
+        indices[i * 6 + 0] = vertex;
+        indices[i * 6 + 1] = vertex + 1;
+        indices[i * 6 + 2] = vertex + 2;
+        indices[i * 6 + 3] = vertex + 2;
+        indices[i * 6 + 4] = vertex + 3;
+        indices[i * 6 + 5] = vertex;
+    }
+
+    // Upload through the array buffer target, binding an element array buffer would leak into the bound vertex array
+    if (quad_index_buffer == 0) {
+        quad_index_buffer = buffer_create(capacity * 6 * sizeof(uint32_t), indices, BUFFER_USAGE_STATIC_DRAW,
+                                          BUFFER_TARGET_ARRAY_BUFFER);
+    } else {
+        buffer_data(quad_index_buffer, BUFFER_TARGET_ARRAY_BUFFER, capacity * 6 * sizeof(uint32_t), indices,
+                    BUFFER_USAGE_STATIC_DRAW);
+    }
+    free(indices);
+
+    LOG_DEBUG("Quad index buffer grown to %zu quads", capacity);
+    quad_index_capacity = capacity;
+    return quad_index_buffer;
+}
+
+mesh_t *mesh_create(const vertex_layout_t *layout, const void *vertices, size_t vertex_count, uint32_t *indices,
+                    size_t index_count, shader_program_t *shader_program, uint32_t texture) {
+    if (layout == NULL) {
+        layout = &default_layout;
+    }
+
     mesh_t *mesh         = malloc(sizeof(mesh_t));
     mesh->shader_program = shader_program;
     mesh->texture        = texture;
 
     mesh->private_data               = malloc(sizeof(mesh_private_data_t));
+    mesh->private_data->layout       = *layout;
     mesh->private_data->vertex_count = vertex_count;
     mesh->private_data->index_count  = index_count;
+    mesh->private_data->quads        = 0;
 
     mesh->private_data->vertex_array = vertex_array_create();
     mesh->private_data->vertex_buffer =
-        buffer_create(vertex_count * sizeof(vertex_t), vertices, BUFFER_USAGE_DYNAMIC_DRAW, BUFFER_TARGET_ARRAY_BUFFER);
+        buffer_create(vertex_count * layout->stride, vertices, BUFFER_USAGE_DYNAMIC_DRAW, BUFFER_TARGET_ARRAY_BUFFER);
     mesh->private_data->index_buffer = buffer_create(index_count * sizeof(uint32_t), indices, BUFFER_USAGE_DYNAMIC_DRAW,
                                                      BUFFER_TARGET_ELEMENT_ARRAY_BUFFER);
 
     vertex_array_bind(mesh->private_data->vertex_array);
     buffer_bind(mesh->private_data->vertex_buffer, BUFFER_TARGET_ARRAY_BUFFER);
-    vertex_array_attrib(0, 3, VERTEX_ARRAY_DATA_TYPE_FLOAT, sizeof(vertex_t), (void *)offsetof(vertex_t, position));
-    vertex_array_attrib(1, 2, VERTEX_ARRAY_DATA_TYPE_FLOAT, sizeof(vertex_t), (void *)offsetof(vertex_t, uv));
+    for (size_t i = 0; i < layout->attribute_count; ++i) {
+        const vertex_attribute_t *attribute = &layout->attributes[i];
+        if (attribute->integer) {
+            vertex_array_attrib_integer(attribute->index, attribute->size, attribute->type, layout->stride,
+                                        (void *)attribute->offset);
+        } else {
+            vertex_array_attrib(attribute->index, attribute->size, attribute->type, layout->stride,
+                                (void *)attribute->offset);
+        }
+    }
     buffer_unbind(BUFFER_TARGET_ARRAY_BUFFER);
     vertex_array_unbind();
 
@@ -56,7 +126,7 @@ void mesh_destroy(mesh_t *mesh) {
     free(mesh);
 }
 
-void mesh_set_vertices(mesh_t *mesh, vertex_t *vertices, size_t vertex_count) {
+void mesh_set_vertices(mesh_t *mesh, const void *vertices, size_t vertex_count) {
     if (!mesh) {
         LOG_ERROR("'mesh_set_vertices' called with NULL mesh");
         return;
@@ -67,17 +137,40 @@ void mesh_set_vertices(mesh_t *mesh, vertex_t *vertices, size_t vertex_count) {
         return;
     }
 
+    size_t stride = mesh->private_data->layout.stride;
     if (vertex_count != mesh->private_data->vertex_count) {
-        buffer_data(mesh->private_data->vertex_buffer, BUFFER_TARGET_ARRAY_BUFFER, vertex_count * sizeof(vertex_t),
-                    vertices, BUFFER_USAGE_DYNAMIC_DRAW);
+        buffer_data(mesh->private_data->vertex_buffer, BUFFER_TARGET_ARRAY_BUFFER, vertex_count * stride, vertices,
+                    BUFFER_USAGE_DYNAMIC_DRAW);
     } else {
-        buffer_sub_data(mesh->private_data->vertex_buffer, BUFFER_TARGET_ARRAY_BUFFER, 0,
-                        vertex_count * sizeof(vertex_t), vertices);
+        buffer_sub_data(mesh->private_data->vertex_buffer, BUFFER_TARGET_ARRAY_BUFFER, 0, vertex_count * stride,
+                        vertices);
     }
 
     mesh->private_data->vertex_count = vertex_count;
 }
 
+void mesh_update_vertices(mesh_t *mesh, size_t offset, const void *vertices, size_t vertex_count) {
+    if (!mesh) {
+        LOG_ERROR("'mesh_update_vertices' called with NULL mesh");
+        return;
+    }
+
+    if (vertices == NULL) {
+        LOG_ERROR("'mesh_update_vertices' called with NULL vertices");
+        return;
+    }
+
+    if (offset + vertex_count > mesh->private_data->vertex_count) {
+        LOG_ERROR("Vertex range %zu-%zu is out of the mesh bounds (%zu vertices)", offset, offset + vertex_count,
+                  mesh->private_data->vertex_count);
+        return;
+    }
+
+    size_t stride = mesh->private_data->layout.stride;
+    buffer_sub_data(mesh->private_data->vertex_buffer, BUFFER_TARGET_ARRAY_BUFFER, offset * stride,
+                    vertex_count * stride, vertices);
+}
+
 void mesh_set_indices(mesh_t *mesh, uint32_t *indices, size_t index_count) {
     if (!mesh) {
         LOG_ERROR("'mesh_set_indices' called with NULL mesh");
@@ -98,6 +191,37 @@ void mesh_set_indices(mesh_t *mesh, uint32_t *indices, size_t index_count) {
     }
 
     mesh->private_data->index_count = index_count;
+    mesh->private_data->quads       = 0;
+}
+
+void mesh_set_quads(mesh_t *mesh, const void *vertices, size_t vertex_count) {
+    if (!mesh) {
+        LOG_ERROR("'mesh_set_quads' called with NULL mesh");
+        return;
+    }
+
+    if (mesh_quad_indices_reserve(vertex_count / 4) == 0) {
+        return;
+    }
+
+    if (vertex_count > 0) {
+        mesh_set_vertices(mesh, vertices, vertex_count);
+    } else {
+        mesh->private_data->vertex_count = 0;
+    }
+
+    mesh->private_data->index_count = vertex_count / 4 * 6;
+    mesh->private_data->quads       = 1;
+}
+
+void mesh_quad_indices_destroy() {
+    if (quad_index_buffer == 0) {
+        return;
+    }
+
+    buffer_destroy(&quad_index_buffer);
+    quad_index_buffer   = 0;
+    quad_index_capacity = 0;
 }
 
 void mesh_bind(mesh_t *mesh) {
@@ -109,7 +233,8 @@ void mesh_bind(mesh_t *mesh) {
     shader_program_use(mesh->shader_program);
     vertex_array_bind(mesh->private_data->vertex_array);
     buffer_bind(mesh->private_data->vertex_buffer, BUFFER_TARGET_ARRAY_BUFFER);
-    buffer_bind(mesh->private_data->index_buffer, BUFFER_TARGET_ELEMENT_ARRAY_BUFFER);
+    buffer_bind(mesh->private_data->quads ? quad_index_buffer : mesh->private_data->index_buffer,
+                BUFFER_TARGET_ELEMENT_ARRAY_BUFFER);
     texture_bind(mesh->texture, 0);
 }
 
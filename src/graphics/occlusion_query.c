@@ -0,0 +1,53 @@
+#include "graphics/occlusion_query.h"
+
+#include <stdlib.h>
+
+#include <glad/glad.h>
+
+#include "core/log.h"
+
+uint32_t occlusion_query_create() {
+    uint32_t query;
+    glGenQueries(1, &query);
+
+    LOG_TRACE("Created occlusion query with ID: %d", query);
+
+    return query;
+}
+
+void occlusion_query_destroy(uint32_t *query) {
+    if (query == NULL) {
+        LOG_ERROR("'occlusion_query_destroy' called with NULL query");
+        return;
+    }
+
+    if (*query == 0) {
+        LOG_WARN("'occlusion_query_destroy' called with 0 query");
+        return;
+    }
+
+    LOG_TRACE("Deleting occlusion query with ID: %d", *query);
+
+    glDeleteQueries(1, query);
+    *query = 0;
+}
+
+void occlusion_query_begin(uint32_t query) { glBeginQuery(GL_ANY_SAMPLES_PASSED, query); }
+
+void occlusion_query_end() { glEndQuery(GL_ANY_SAMPLES_PASSED); }
+
+int occlusion_query_available(uint32_t query) {
+    GLuint available = GL_FALSE;
+    glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+    return available == GL_TRUE;
+}
+
+int occlusion_query_passed(uint32_t query) {
+    GLuint passed = GL_FALSE;
+    glGetQueryObjectuiv(query, GL_QUERY_RESULT, &passed);
+    return passed != GL_FALSE;
+}
+
+void occlusion_query_begin_conditional(uint32_t query) { glBeginConditionalRender(query, GL_QUERY_WAIT); }
+
+void occlusion_query_end_conditional() { glEndConditionalRender(); }
@@ -1,17 +1,35 @@
 #include "graphics/renderer.h"
 
 #include <glad/glad.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "core/log.h"
 #include "core/math.h"
 #include "graphics/buffer.h"
+#include "graphics/gl_state.h"
+#include "graphics/texture.h"
+#include "graphics/uniform_ring.h"
 #include "graphics/vertex.h"
 #include "graphics/vertex_array.h"
 #include "graphics/window.h"
 
+#define DRAW_BATCH_BASE_CAPACITY 256
+
+// Uniform buffer binding points of the `Matrices` block, shared by every draw, and of the per draw `Object` block
+#define MATRICES_BINDING 0
+#define OBJECT_BINDING   1
+
+// Bytes of per draw uniforms a frame starts out with, room for a few hundred model matrices
+#define UNIFORM_RING_FRAME_SIZE (64 * 1024)
+
 typedef struct {
+    // View and projection matrices
     uint32_t uniform_buffer;
 
+    // Per draw uniforms, appended once per draw instead of overwriting a buffer earlier draws may still read
+    uniform_ring_t *uniform_ring;
+
     renderer_state_t state;
 } renderer_t;
 
@@ -20,7 +38,8 @@ static renderer_t renderer;
 static void set_perspective(ivec2s size) {
     mat4s projection = glms_perspective(RAD(camera_get_fov(renderer.state.camera)), (float)size.x / (float)size.y,
                                         renderer.state.near_clip, renderer.state.far_clip);
-    buffer_sub_data(renderer.uniform_buffer, BUFFER_TARGET_UNIFORM_BUFFER, sizeof(mat4) * 2, sizeof(mat4), &projection);
+    buffer_sub_data(renderer.uniform_buffer, BUFFER_TARGET_UNIFORM_BUFFER, sizeof(mat4), sizeof(mat4), &projection);
+    camera_set_projection(renderer.state.camera, projection);
 }
 
 int renderer_init(renderer_settings_t settings) {
@@ -29,7 +48,12 @@ int renderer_init(renderer_settings_t settings) {
     renderer.state.far_clip    = settings.far_clip;
 
     renderer.uniform_buffer =
-        buffer_create(sizeof(mat4) * 3, NULL, BUFFER_USAGE_STATIC_DRAW, BUFFER_TARGET_UNIFORM_BUFFER);
+        buffer_create(sizeof(mat4) * 2, NULL, BUFFER_USAGE_STATIC_DRAW, BUFFER_TARGET_UNIFORM_BUFFER);
+    renderer.uniform_ring = uniform_ring_create(UNIFORM_RING_FRAME_SIZE);
+    if (renderer.uniform_ring == NULL) {
+        LOG_ERROR("Failed to create the uniform ring");
+        return -1;
+    }
     renderer.state.camera = camera_create(settings.camera_settings);
 
     set_perspective(window_get_framebuffer_size());
@@ -49,6 +73,9 @@ int renderer_init(renderer_settings_t settings) {
     // Default to solid rendering
     renderer.state.wireframe = 0;
 
+    // Occlusion queries are opt-in, the CPU side visibility search already hides most of the world underground
+    renderer.state.occlusion_queries = 0;
+
     // Get the maximum anisotropy level
     glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &renderer.state.max_anisotropy);
 
@@ -64,6 +91,8 @@ int renderer_init(renderer_settings_t settings) {
 
 void renderer_deinit() {
     buffer_destroy(&renderer.uniform_buffer);
+    uniform_ring_destroy(renderer.uniform_ring);
+    mesh_quad_indices_destroy();
     camera_destroy(renderer.state.camera);
 
     LOG_INFO("Renderer deinitialized");
@@ -79,41 +108,170 @@ void renderer_begin_frame() {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glClearColor(renderer.state.clear_color.x, renderer.state.clear_color.y, renderer.state.clear_color.z, 1.0f);
 
+    uniform_ring_begin_frame(renderer.uniform_ring);
+
     if (camera_view_changed(renderer.state.camera)) {
         mat4s view = camera_get_view(renderer.state.camera);
-        buffer_sub_data(renderer.uniform_buffer, BUFFER_TARGET_UNIFORM_BUFFER, sizeof(mat4), sizeof(mat4), &view);
+        buffer_sub_data(renderer.uniform_buffer, BUFFER_TARGET_UNIFORM_BUFFER, 0, sizeof(mat4), &view);
         camera_view_reset(renderer.state.camera);
     }
 }
 
 void renderer_end_frame() {
+    uniform_ring_end_frame(renderer.uniform_ring);
     vertex_array_unbind();
     window_swap_buffers();
+
+    renderer.state.gl_state_counters = gl_state_get_counters();
+    gl_state_reset_counters();
 }
 
-void renderer_draw_mesh(mesh_t *mesh, vec3s position, vec3s rotation, vec3s scale) {
-    if (!mesh) {
-        LOG_ERROR("'renderer_draw_mesh' called with NULL mesh");
-        return;
+// Most meshes are only moved and scaled, e.g. occlusion query bounds. Their model matrix is written directly instead
+// of composing rotations.
+static mat4s model_matrix(vec3s position, vec3s rotation, vec3s scale) {
+    if (rotation.x == 0.0f && rotation.y == 0.0f && rotation.z == 0.0f) {
+        mat4s model     = glms_mat4_identity();
+        model.raw[0][0] = scale.x;
+        model.raw[1][1] = scale.y;
+        model.raw[2][2] = scale.z;
+        model.raw[3][0] = position.x;
+        model.raw[3][1] = position.y;
+        model.raw[3][2] = position.z;
+        return model;
     }
 
-    buffer_bind_base(renderer.uniform_buffer, BUFFER_TARGET_UNIFORM_BUFFER, 0);
-    shader_program_bind_uniform_block(mesh->shader_program, "Matrices", 0);
-
-    mesh_bind(mesh);
-
     mat4s model = glms_mat4_identity();
     model       = glms_translate(model, position);
     model       = glms_rotate(model, rotation.x, (vec3s) {{1.0f, 0.0f, 0.0f}});
     model       = glms_rotate(model, rotation.y, (vec3s) {{0.0f, 1.0f, 0.0f}});
     model       = glms_rotate(model, rotation.z, (vec3s) {{0.0f, 0.0f, 1.0f}});
     model       = glms_scale(model, scale);
+    return model;
+}
 
-    buffer_sub_data(renderer.uniform_buffer, BUFFER_TARGET_UNIFORM_BUFFER, 0, sizeof(mat4), &model);
+void renderer_draw_mesh(mesh_t *mesh, vec3s position, vec3s rotation, vec3s scale) {
+    if (!mesh) {
+        LOG_ERROR("'renderer_draw_mesh' called with NULL mesh");
+        return;
+    }
+
+    buffer_bind_base(renderer.uniform_buffer, BUFFER_TARGET_UNIFORM_BUFFER, MATRICES_BINDING);
+    shader_program_bind_uniform_block(mesh->shader_program, "Matrices", MATRICES_BINDING);
+    shader_program_bind_uniform_block(mesh->shader_program, "Object", OBJECT_BINDING);
+
+    mat4s model = model_matrix(position, rotation, scale);
+    if (uniform_ring_push(renderer.uniform_ring, &model, sizeof(mat4), OBJECT_BINDING) != 0) {
+        return;
+    }
 
+    mesh_bind(mesh);
+
+    // Bindings are left in place, the next draw only changes what differs
     glDrawElements(GL_TRIANGLES, mesh_get_index_count(mesh), GL_UNSIGNED_INT, 0);
+}
+
+static int draw_batch_reserve(renderer_draw_batch_t *batch, size_t capacity) {
+    int *counts          = malloc(capacity * sizeof(int));
+    const void **offsets = malloc(capacity * sizeof(const void *));
+    int *base_vertices   = malloc(capacity * sizeof(int));
+    if (counts == NULL || offsets == NULL || base_vertices == NULL) {
+        LOG_ERROR("Failed to allocate draw batch");
+        free(counts);
+        free(offsets);
+        free(base_vertices);
+        return -1;
+    }
+
+    if (batch->count > 0) {
+        memcpy(counts, batch->counts, batch->count * sizeof(int));
+        memcpy(offsets, batch->offsets, batch->count * sizeof(const void *));
+        memcpy(base_vertices, batch->base_vertices, batch->count * sizeof(int));
+    }
+
+    free(batch->counts);
+    free(batch->offsets);
+    free(batch->base_vertices);
+    batch->counts        = counts;
+    batch->offsets       = offsets;
+    batch->base_vertices = base_vertices;
+    batch->capacity      = capacity;
+    return 0;
+}
+
+int renderer_draw_batch_init(renderer_draw_batch_t *batch, size_t capacity) {
+    if (!batch) {
+        LOG_ERROR("'renderer_draw_batch_init' called with NULL batch");
+        return -1;
+    }
+
+    memset(batch, 0, sizeof(renderer_draw_batch_t));
+    return draw_batch_reserve(batch, capacity > 0 ? capacity : DRAW_BATCH_BASE_CAPACITY);
+}
+
+void renderer_draw_batch_free(renderer_draw_batch_t *batch) {
+    if (!batch) {
+        LOG_ERROR("'renderer_draw_batch_free' called with NULL batch");
+        return;
+    }
 
-    mesh_unbind();
+    free(batch->counts);
+    free(batch->offsets);
+    free(batch->base_vertices);
+    memset(batch, 0, sizeof(renderer_draw_batch_t));
+}
+
+int renderer_draw_batch_push(renderer_draw_batch_t *batch, renderer_index_range_t range, size_t base_vertex) {
+    if (batch->count == batch->capacity &&
+        draw_batch_reserve(batch, batch->capacity ? batch->capacity * 2 : DRAW_BATCH_BASE_CAPACITY) != 0) {
+        return -1;
+    }
+
+    size_t i                = batch->count++;
+    batch->counts[i]        = (int)range.count;
+    batch->offsets[i]       = (const void *)(range.first * sizeof(uint32_t));
+    batch->base_vertices[i] = (int)base_vertex;
+    return 0;
+}
+
+void renderer_draw_pool_batch(vertex_pool_t *pool, shader_program_t *shader_program, uint32_t texture,
+                              renderer_draw_batch_t *batch) {
+    if (!pool) {
+        LOG_ERROR("'renderer_draw_pool_batch' called with NULL pool");
+        return;
+    }
+
+    if (!batch) {
+        LOG_ERROR("'renderer_draw_pool_batch' called with NULL batch");
+        return;
+    }
+
+    if (batch->count == 0) {
+        return;
+    }
+
+    buffer_bind_base(renderer.uniform_buffer, BUFFER_TARGET_UNIFORM_BUFFER, MATRICES_BINDING);
+    shader_program_bind_uniform_block(shader_program, "Matrices", MATRICES_BINDING);
+
+    shader_program_use(shader_program);
+    vertex_pool_bind(pool);
+    texture_bind(texture, 0);
+
+    glMultiDrawElementsBaseVertex(GL_TRIANGLES, batch->counts, GL_UNSIGNED_INT, batch->offsets, batch->count,
+                                  batch->base_vertices);
+
+    batch->count = 0;
+}
+
+void renderer_begin_occlusion_pass() {
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthMask(GL_FALSE);
+    glDisable(GL_CULL_FACE);
+}
+
+void renderer_end_occlusion_pass() {
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glDepthMask(GL_TRUE);
+    glEnable(GL_CULL_FACE);
 }
 
 camera_t *renderer_get_camera() { return renderer.state.camera; }
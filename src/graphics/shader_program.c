@@ -6,10 +6,14 @@
 #include <glad/glad.h>
 
 #include "core/log.h"
+#include "graphics/gl_state.h"
 
 struct shader_program{
     uint32_t id;
     char *uniform_block_indeces[UNIFROM_BLOCK_INDEX_SIZE];
+
+    // Index of the last block looked up, callers tend to ask for the same blocks over and over
+    size_t last_uniform_block;
 };
 
 static void print_info_log(uint32_t program, const char *message) {
@@ -37,6 +41,7 @@ shader_program_t *shader_program_create() {
     }
 
     memset(program->uniform_block_indeces, 0, sizeof(program->uniform_block_indeces));
+    program->last_uniform_block = 0;
 
     LOG_TRACE("Created shader program with ID: %d", program->id);
     return program;
@@ -50,6 +55,7 @@ void shader_program_destroy(shader_program_t *program) {
 
     LOG_TRACE("Destroying shader program with ID: %d", program->id);
 
+    gl_state_forget_program(program->id);
     glDeleteProgram(program->id);
 
     for (size_t i = 0; i < UNIFROM_BLOCK_INDEX_SIZE; i++) {
@@ -91,7 +97,7 @@ void shader_program_use(shader_program_t *program) {
         return;
     }
 
-    glUseProgram(program->id);
+    gl_state_use_program(program->id);
 }
 
 uint32_t shader_program_get_uniform_block_index(shader_program_t *program, const char *name) {
@@ -100,8 +106,14 @@ uint32_t shader_program_get_uniform_block_index(shader_program_t *program, const
         return GL_INVALID_INDEX;
     }
 
+    const char *last = program->uniform_block_indeces[program->last_uniform_block];
+    if (last && strcmp(last, name) == 0) {
+        return program->last_uniform_block;
+    }
+
     for (size_t i = 0; i < UNIFROM_BLOCK_INDEX_SIZE; i++) {
         if (program->uniform_block_indeces[i] && strcmp(program->uniform_block_indeces[i], name) == 0) {
+            program->last_uniform_block = i;
             return i;
         }
     }
@@ -112,12 +124,18 @@ uint32_t shader_program_get_uniform_block_index(shader_program_t *program, const
         return GL_INVALID_INDEX;
     }
 
+    if (index >= UNIFROM_BLOCK_INDEX_SIZE) {
+        LOG_ERROR("Uniform block '%s' index %d is past the cached indices", name, index);
+        return index;
+    }
+
     if (program->uniform_block_indeces[index]) {
         free(program->uniform_block_indeces[index]);
         LOG_WARN("Uniform block index %d was overwritten", index);
     }
 
     program->uniform_block_indeces[index] = strdup(name);
+    program->last_uniform_block           = index;
     LOG_DEBUG("Uniform block '%s' index: %d", name, index);
 
     return index;
@@ -130,5 +148,29 @@ void shader_program_bind_uniform_block(shader_program_t *program, const char *na
     }
 
     uint32_t index = shader_program_get_uniform_block_index(program, name);
-    glUniformBlockBinding(program->id, index, binding_point);
+    if (index == GL_INVALID_INDEX) {
+        return;
+    }
+
+    gl_state_uniform_block_binding(program->id, index, binding_point);
+}
+
+void shader_program_set_int(shader_program_t *program, const char *name, int value) {
+    if (program == NULL) {
+        LOG_ERROR("'shader_program_set_int' called with NULL program");
+        return;
+    }
+
+    gl_state_use_program(program->id);
+    glUniform1i(glGetUniformLocation(program->id, name), value);
+}
+
+void shader_program_set_float(shader_program_t *program, const char *name, float value) {
+    if (program == NULL) {
+        LOG_ERROR("'shader_program_set_float' called with NULL program");
+        return;
+    }
+
+    gl_state_use_program(program->id);
+    glUniform1f(glGetUniformLocation(program->id, name), value);
 }
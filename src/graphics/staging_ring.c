@@ -0,0 +1,165 @@
+#include "graphics/staging_ring.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/log.h"
+#include "graphics/buffer.h"
+#include "graphics/fence.h"
+
+// Writes start at this alignment, keeps the mapped ranges friendly to the copies out of them
+#define STAGING_RING_ALIGNMENT 16
+
+struct staging_ring {
+    uint32_t buffer;
+
+    // Bytes of every frame's part, a multiple of the alignment
+    size_t frame_capacity;
+
+    // Part written this frame and the next free byte in it
+    int frame;
+    size_t offset;
+
+    fence_t fences[STAGING_RING_FRAMES];
+
+    // Times the buffer was orphaned because the GPU fell behind
+    size_t orphan_count;
+};
+
+static size_t align_up(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+staging_ring_t *staging_ring_create(size_t frame_capacity) {
+    staging_ring_t *ring = calloc(1, sizeof(staging_ring_t));
+    if (ring == NULL) {
+        LOG_ERROR("Failed to allocate staging ring");
+        return NULL;
+    }
+
+    ring->frame_capacity = align_up(frame_capacity > 0 ? frame_capacity : 1, STAGING_RING_ALIGNMENT);
+    ring->buffer         = buffer_create(ring->frame_capacity * STAGING_RING_FRAMES, NULL, BUFFER_USAGE_STREAM_COPY,
+                                         BUFFER_TARGET_COPY_READ_BUFFER);
+    if (ring->buffer == 0) {
+        LOG_ERROR("Failed to create staging ring buffer of %zu bytes", ring->frame_capacity * STAGING_RING_FRAMES);
+        free(ring);
+        return NULL;
+    }
+
+    return ring;
+}
+
+void staging_ring_destroy(staging_ring_t *ring) {
+    if (ring == NULL) {
+        LOG_ERROR("'staging_ring_destroy' called with NULL ring");
+        return;
+    }
+
+    LOG_DEBUG("Staging ring orphaned %zu times", ring->orphan_count);
+
+    for (int i = 0; i < STAGING_RING_FRAMES; ++i) {
+        fence_destroy(&ring->fences[i]);
+    }
+    buffer_destroy(&ring->buffer);
+    free(ring);
+}
+
+void staging_ring_begin_frame(staging_ring_t *ring) {
+    if (ring == NULL) {
+        LOG_ERROR("'staging_ring_begin_frame' called with NULL ring");
+        return;
+    }
+
+    ring->frame  = (ring->frame + 1) % STAGING_RING_FRAMES;
+    ring->offset = 0;
+
+    fence_t *fence = &ring->fences[ring->frame];
+    if (*fence == NULL) {
+        return;
+    }
+
+    if (fence_signaled(*fence)) {
+        fence_destroy(fence);
+        return;
+    }
+
+    // Fresh storage for the whole ring, the copies still reading the old one keep it alive until they are done
+    buffer_data(ring->buffer, BUFFER_TARGET_COPY_READ_BUFFER, ring->frame_capacity * STAGING_RING_FRAMES, NULL,
+                BUFFER_USAGE_STREAM_COPY);
+    for (int i = 0; i < STAGING_RING_FRAMES; ++i) {
+        fence_destroy(&ring->fences[i]);
+    }
+    ++ring->orphan_count;
+}
+
+void staging_ring_end_frame(staging_ring_t *ring) {
+    if (ring == NULL) {
+        LOG_ERROR("'staging_ring_end_frame' called with NULL ring");
+        return;
+    }
+
+    // Nothing to fence if the frame uploaded nothing
+    if (ring->offset == 0) {
+        return;
+    }
+
+    fence_destroy(&ring->fences[ring->frame]);
+    ring->fences[ring->frame] = fence_create();
+}
+
+int staging_ring_upload(staging_ring_t *ring, uint32_t destination, size_t destination_offset, const void *data,
+                        size_t size) {
+    if (ring == NULL) {
+        LOG_ERROR("'staging_ring_upload' called with NULL ring");
+        return -1;
+    }
+
+    if (data == NULL) {
+        LOG_ERROR("'staging_ring_upload' called with NULL data");
+        return -1;
+    }
+
+    if (size == 0) {
+        return 0;
+    }
+
+    if (size > staging_ring_get_available(ring)) {
+        return -1;
+    }
+
+    // The fence of this part was signaled or the buffer orphaned, nothing reads the range anymore
+    size_t offset = ring->frame * ring->frame_capacity + ring->offset;
+    void *mapped  = buffer_map_range(ring->buffer, BUFFER_TARGET_COPY_READ_BUFFER, offset, size,
+                                     BUFFER_ACCESS_WRITE | BUFFER_ACCESS_INVALIDATE_RANGE |
+                                         BUFFER_ACCESS_UNSYNCHRONIZED);
+    if (mapped == NULL) {
+        return -1;
+    }
+
+    memcpy(mapped, data, size);
+    if (buffer_unmap(ring->buffer, BUFFER_TARGET_COPY_READ_BUFFER) != 0) {
+        LOG_WARN("Staging ring contents were lost while mapped");
+        return -1;
+    }
+
+    buffer_copy_sub_data(ring->buffer, destination, offset, destination_offset, size);
+
+    ring->offset = align_up(ring->offset + size, STAGING_RING_ALIGNMENT);
+    return 0;
+}
+
+size_t staging_ring_get_available(staging_ring_t *ring) {
+    if (ring == NULL) {
+        LOG_ERROR("'staging_ring_get_available' called with NULL ring");
+        return 0;
+    }
+
+    return ring->offset < ring->frame_capacity ? ring->frame_capacity - ring->offset : 0;
+}
+
+size_t staging_ring_get_capacity(staging_ring_t *ring) {
+    if (ring == NULL) {
+        LOG_ERROR("'staging_ring_get_capacity' called with NULL ring");
+        return 0;
+    }
+
+    return ring->frame_capacity;
+}
@@ -3,6 +3,7 @@
 #include <glad/glad.h>
 
 #include "core/log.h"
+#include "graphics/gl_state.h"
 
 uint32_t texture_create() {
     uint32_t texture;
@@ -17,13 +18,13 @@ void texture_bind(uint32_t texture, uint32_t slot) {
         return;
     }
 
-    glActiveTexture(GL_TEXTURE0 + slot);
-    glBindTexture(GL_TEXTURE_2D, texture);
+    gl_state_active_texture(slot);
+    gl_state_bind_texture(GL_TEXTURE_2D, texture);
 }
 
 void texture_unbind(uint32_t slot) {
-    glActiveTexture(GL_TEXTURE0 + slot);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    gl_state_active_texture(slot);
+    gl_state_bind_texture(GL_TEXTURE_2D, 0);
 }
 
 void texture_set_data(uint32_t texture, const uint8_t *data, int width, int height, image_format_t format) {
@@ -54,9 +55,9 @@ void texture_set_data(uint32_t texture, const uint8_t *data, int width, int heig
             return;
     }
 
-    glBindTexture(GL_TEXTURE_2D, texture);
+    gl_state_bind_texture(GL_TEXTURE_2D, texture);
     glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, display_format, GL_UNSIGNED_BYTE, data);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    gl_state_bind_texture(GL_TEXTURE_2D, 0);
 }
 
 void texture_set_image(uint32_t texture, image_t *image) {
@@ -79,10 +80,10 @@ void texture_set_wrapping(uint32_t texture, texture_wrapping_t s, texture_wrappi
         return;
     }
 
-    glBindTexture(GL_TEXTURE_2D, texture);
+    gl_state_bind_texture(GL_TEXTURE_2D, texture);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, s);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, t);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    gl_state_bind_texture(GL_TEXTURE_2D, 0);
 }
 
 void texture_set_filtering(uint32_t texture, texture_filtering_t min, texture_filtering_t mag) {
@@ -91,10 +92,10 @@ void texture_set_filtering(uint32_t texture, texture_filtering_t min, texture_fi
         return;
     }
 
-    glBindTexture(GL_TEXTURE_2D, texture);
+    gl_state_bind_texture(GL_TEXTURE_2D, texture);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, min);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, mag);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    gl_state_bind_texture(GL_TEXTURE_2D, 0);
 }
 
 void texture_generate_mipmaps(uint32_t texture) {
@@ -103,9 +104,9 @@ void texture_generate_mipmaps(uint32_t texture) {
         return;
     }
 
-    glBindTexture(GL_TEXTURE_2D, texture);
+    gl_state_bind_texture(GL_TEXTURE_2D, texture);
     glGenerateMipmap(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    gl_state_bind_texture(GL_TEXTURE_2D, 0);
 }
 
 void texture_set_anisotropy(uint32_t texture, float anisotropy) {
@@ -114,9 +115,30 @@ void texture_set_anisotropy(uint32_t texture, float anisotropy) {
         return;
     }
 
-    glBindTexture(GL_TEXTURE_2D, texture);
+    gl_state_bind_texture(GL_TEXTURE_2D, texture);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY, anisotropy);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    gl_state_bind_texture(GL_TEXTURE_2D, 0);
+}
+
+void texture_set_buffer(uint32_t texture, uint32_t buffer) {
+    if (texture == 0) {
+        LOG_ERROR("'texture_set_buffer' called with 0 texture");
+        return;
+    }
+
+    gl_state_bind_texture(GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer);
+    gl_state_bind_texture(GL_TEXTURE_BUFFER, 0);
+}
+
+void texture_bind_buffer(uint32_t texture, uint32_t slot) {
+    if (texture == 0) {
+        LOG_ERROR("'texture_bind_buffer' called with 0 texture");
+        return;
+    }
+
+    gl_state_active_texture(slot);
+    gl_state_bind_texture(GL_TEXTURE_BUFFER, texture);
 }
 
 void texture_destroy(uint32_t *texture) {
@@ -131,5 +153,6 @@ void texture_destroy(uint32_t *texture) {
     }
 
     LOG_TRACE("Deleting texture with ID: %d", *texture);
+    gl_state_forget_texture(*texture);
     glDeleteTextures(1, texture);
 }
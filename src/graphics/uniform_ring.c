@@ -0,0 +1,143 @@
+#include "graphics/uniform_ring.h"
+
+#include <stdlib.h>
+
+#include <glad/glad.h>
+
+#include "core/log.h"
+#include "graphics/buffer.h"
+#include "graphics/fence.h"
+
+// A frame waiting this long for the GPU to release its part of the ring gives up and overwrites it
+#define UNIFORM_RING_FENCE_TIMEOUT 1000000000ull
+
+struct uniform_ring {
+    uint32_t buffer;
+
+    // Bytes of every frame's part, a multiple of the alignment
+    size_t frame_capacity;
+
+    // Offset alignment required by uniform buffer ranges
+    size_t alignment;
+
+    // Part written this frame and the next free byte in it
+    int frame;
+    size_t offset;
+
+    fence_t fences[UNIFORM_RING_FRAMES];
+};
+
+static size_t align_up(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+static int create_buffer(uniform_ring_t *ring, size_t frame_capacity) {
+    uint32_t buffer = buffer_create(frame_capacity * UNIFORM_RING_FRAMES, NULL, BUFFER_USAGE_STREAM_DRAW,
+                                    BUFFER_TARGET_UNIFORM_BUFFER);
+    if (buffer == 0) {
+        LOG_ERROR("Failed to create uniform ring buffer of %zu bytes", frame_capacity * UNIFORM_RING_FRAMES);
+        return -1;
+    }
+
+    // Draws still reading the old buffer keep it alive until they are done
+    if (ring->buffer) {
+        buffer_destroy(&ring->buffer);
+    }
+
+    // Nothing reads the new buffer yet
+    for (int i = 0; i < UNIFORM_RING_FRAMES; ++i) {
+        fence_destroy(&ring->fences[i]);
+    }
+
+    ring->buffer         = buffer;
+    ring->frame_capacity = frame_capacity;
+    ring->offset         = 0;
+    return 0;
+}
+
+uniform_ring_t *uniform_ring_create(size_t frame_capacity) {
+    uniform_ring_t *ring = calloc(1, sizeof(uniform_ring_t));
+    if (ring == NULL) {
+        LOG_ERROR("Failed to allocate uniform ring");
+        return NULL;
+    }
+
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    ring->alignment = alignment > 0 ? (size_t)alignment : 256;
+
+    if (create_buffer(ring, align_up(frame_capacity > 0 ? frame_capacity : 1, ring->alignment)) != 0) {
+        free(ring);
+        return NULL;
+    }
+
+    return ring;
+}
+
+void uniform_ring_destroy(uniform_ring_t *ring) {
+    if (ring == NULL) {
+        LOG_ERROR("'uniform_ring_destroy' called with NULL ring");
+        return;
+    }
+
+    for (int i = 0; i < UNIFORM_RING_FRAMES; ++i) {
+        fence_destroy(&ring->fences[i]);
+    }
+    buffer_destroy(&ring->buffer);
+    free(ring);
+}
+
+void uniform_ring_begin_frame(uniform_ring_t *ring) {
+    if (ring == NULL) {
+        LOG_ERROR("'uniform_ring_begin_frame' called with NULL ring");
+        return;
+    }
+
+    ring->frame  = (ring->frame + 1) % UNIFORM_RING_FRAMES;
+    ring->offset = 0;
+
+    fence_t *fence = &ring->fences[ring->frame];
+    if (*fence) {
+        fence_wait(*fence, UNIFORM_RING_FENCE_TIMEOUT);
+        fence_destroy(fence);
+    }
+}
+
+void uniform_ring_end_frame(uniform_ring_t *ring) {
+    if (ring == NULL) {
+        LOG_ERROR("'uniform_ring_end_frame' called with NULL ring");
+        return;
+    }
+
+    fence_destroy(&ring->fences[ring->frame]);
+    ring->fences[ring->frame] = fence_create();
+}
+
+int uniform_ring_push(uniform_ring_t *ring, const void *data, size_t size, uint32_t binding_point) {
+    if (ring == NULL) {
+        LOG_ERROR("'uniform_ring_push' called with NULL ring");
+        return -1;
+    }
+
+    if (data == NULL) {
+        LOG_ERROR("'uniform_ring_push' called with NULL data");
+        return -1;
+    }
+
+    if (ring->offset + size > ring->frame_capacity) {
+        size_t capacity = ring->frame_capacity * 2;
+        while (capacity < size) {
+            capacity *= 2;
+        }
+
+        LOG_DEBUG("Uniform ring grown to %zu bytes per frame", capacity);
+        if (create_buffer(ring, capacity) != 0) {
+            return -1;
+        }
+    }
+
+    size_t offset = ring->frame * ring->frame_capacity + ring->offset;
+    buffer_sub_data(ring->buffer, BUFFER_TARGET_UNIFORM_BUFFER, offset, size, data);
+    buffer_bind_range(ring->buffer, BUFFER_TARGET_UNIFORM_BUFFER, binding_point, offset, size);
+
+    ring->offset += align_up(size, ring->alignment);
+    return 0;
+}
@@ -3,6 +3,7 @@
 #include <glad/glad.h>
 
 #include "core/log.h"
+#include "graphics/gl_state.h"
 
 uint32_t vertex_array_create() {
     uint32_t vertex_array;
@@ -23,6 +24,7 @@ void vertex_array_destroy(uint32_t *vertex_array) {
     }
 
     LOG_TRACE("Deleting vertex array with ID: %d", *vertex_array);
+    gl_state_forget_vertex_array(*vertex_array);
     glDeleteVertexArrays(1, vertex_array);
 }
 
@@ -32,14 +34,20 @@ void vertex_array_bind(uint32_t vertex_array) {
         return;
     }
     
-    glBindVertexArray(vertex_array);
+    gl_state_bind_vertex_array(vertex_array);
 }
 
 void vertex_array_unbind() {
-    glBindVertexArray(0);
+    gl_state_bind_vertex_array(0);
 }
 
 void vertex_array_attrib(uint32_t index, int size, vertex_array_data_type_t type, int stride, const void *pointer) {
     glEnableVertexAttribArray(index);
     glVertexAttribPointer(index, size, type, GL_FALSE, stride, pointer);
 }
+
+void vertex_array_attrib_integer(uint32_t index, int size, vertex_array_data_type_t type, int stride,
+                                 const void *pointer) {
+    glEnableVertexAttribArray(index);
+    glVertexAttribIPointer(index, size, type, stride, pointer);
+}
@@ -0,0 +1,465 @@
+#include "graphics/vertex_pool.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/log.h"
+#include "graphics/buffer.h"
+#include "graphics/mesh.h"
+#include "graphics/texture.h"
+#include "graphics/vertex_array.h"
+
+#define VERTEX_POOL_BASE_LIST_CAPACITY 64
+
+// Page origins written by a single buffer update
+#define VERTEX_POOL_ORIGIN_BATCH 64
+
+#define PAGES(vertices) (((vertices) + VERTEX_POOL_PAGE_SIZE - 1) / VERTEX_POOL_PAGE_SIZE)
+
+// Unallocated vertices, `offset` and `count` in vertices
+typedef struct {
+    size_t offset;
+    size_t count;
+} vertex_pool_range_t;
+
+struct vertex_pool {
+    vertex_layout_t layout;
+
+    uint32_t vertex_array;
+    uint32_t vertex_buffer;
+
+    // Quad index buffer attached to the vertex array, zero until the first bind
+    uint32_t index_buffer;
+
+    // Origin of every page as a `vec4`, read through the buffer texture
+    uint32_t origin_buffer;
+    uint32_t origin_texture;
+
+    size_t capacity;
+    size_t used;
+
+    // Holes sorted by offset, neighboring holes are always merged
+    vertex_pool_range_t *free_ranges;
+    size_t free_count;
+    size_t free_capacity;
+
+    // Live allocations, each one knows its position in the list
+    vertex_pool_allocation_t **allocations;
+    size_t allocation_count;
+    size_t allocation_capacity;
+};
+
+static void set_attributes(vertex_pool_t *pool) {
+    const vertex_layout_t *layout = &pool->layout;
+
+    vertex_array_bind(pool->vertex_array);
+    buffer_bind(pool->vertex_buffer, BUFFER_TARGET_ARRAY_BUFFER);
+    for (size_t i = 0; i < layout->attribute_count; ++i) {
+        const vertex_attribute_t *attribute = &layout->attributes[i];
+        if (attribute->integer) {
+            vertex_array_attrib_integer(attribute->index, attribute->size, attribute->type, layout->stride,
+                                        (void *)attribute->offset);
+        } else {
+            vertex_array_attrib(attribute->index, attribute->size, attribute->type, layout->stride,
+                                (void *)attribute->offset);
+        }
+    }
+    buffer_unbind(BUFFER_TARGET_ARRAY_BUFFER);
+    vertex_array_unbind();
+}
+
+static int free_list_insert(vertex_pool_t *pool, size_t offset, size_t count) {
+    size_t i = 0;
+    while (i < pool->free_count && pool->free_ranges[i].offset < offset) {
+        ++i;
+    }
+
+    vertex_pool_range_t *previous = i > 0 ? &pool->free_ranges[i - 1] : NULL;
+    vertex_pool_range_t *next     = i < pool->free_count ? &pool->free_ranges[i] : NULL;
+    int merge_previous            = previous && previous->offset + previous->count == offset;
+    int merge_next                = next && offset + count == next->offset;
+
+    if (merge_previous && merge_next) {
+        previous->count += count + next->count;
+        memmove(next, next + 1, (pool->free_count - i - 1) * sizeof(vertex_pool_range_t));
+        --pool->free_count;
+        return 0;
+    }
+
+    if (merge_previous) {
+        previous->count += count;
+        return 0;
+    }
+
+    if (merge_next) {
+        next->offset = offset;
+        next->count += count;
+        return 0;
+    }
+
+    if (pool->free_count == pool->free_capacity) {
+        size_t capacity = pool->free_capacity ? pool->free_capacity * 2 : VERTEX_POOL_BASE_LIST_CAPACITY;
+        vertex_pool_range_t *ranges = realloc(pool->free_ranges, capacity * sizeof(vertex_pool_range_t));
+        if (ranges == NULL) {
+            LOG_ERROR("Failed to grow the vertex pool free list, %zu vertices are lost", count);
+            return -1;
+        }
+        pool->free_ranges   = ranges;
+        pool->free_capacity = capacity;
+    }
+
+    memmove(&pool->free_ranges[i + 1], &pool->free_ranges[i], (pool->free_count - i) * sizeof(vertex_pool_range_t));
+    pool->free_ranges[i] = (vertex_pool_range_t) {offset, count};
+    ++pool->free_count;
+    return 0;
+}
+
+// Allocates the first `count` vertices of a hole
+static size_t free_list_take(vertex_pool_t *pool, size_t index, size_t count) {
+    vertex_pool_range_t *range = &pool->free_ranges[index];
+    size_t offset              = range->offset;
+
+    range->offset += count;
+    range->count -= count;
+    if (range->count == 0) {
+        memmove(range, range + 1, (pool->free_count - index - 1) * sizeof(vertex_pool_range_t));
+        --pool->free_count;
+    }
+    return offset;
+}
+
+static void write_origins(vertex_pool_t *pool, const vertex_pool_allocation_t *allocation) {
+    vec4s origins[VERTEX_POOL_ORIGIN_BATCH];
+    for (size_t i = 0; i < VERTEX_POOL_ORIGIN_BATCH; ++i) {
+        origins[i] = glms_vec4(allocation->origin, 0.0f);
+    }
+
+    size_t page = allocation->offset / VERTEX_POOL_PAGE_SIZE;
+    size_t end  = page + allocation->count / VERTEX_POOL_PAGE_SIZE;
+    while (page < end) {
+        size_t count = end - page < VERTEX_POOL_ORIGIN_BATCH ? end - page : VERTEX_POOL_ORIGIN_BATCH;
+        buffer_sub_data(pool->origin_buffer, BUFFER_TARGET_TEXTURE_BUFFER, page * sizeof(vec4s), count * sizeof(vec4s),
+                        origins);
+        page += count;
+    }
+}
+
+// Moves the vertices into a buffer at least `count` vertices larger, the new space joins the free list
+static int grow(vertex_pool_t *pool, size_t count) {
+    size_t capacity = pool->capacity;
+    while (capacity - pool->capacity < count) {
+        capacity *= 2;
+    }
+
+    uint32_t buffer =
+        buffer_create(capacity * pool->layout.stride, NULL, BUFFER_USAGE_DYNAMIC_DRAW, BUFFER_TARGET_ARRAY_BUFFER);
+    uint32_t origin_buffer = buffer_create(PAGES(capacity) * sizeof(vec4s), NULL, BUFFER_USAGE_DYNAMIC_DRAW,
+                                           BUFFER_TARGET_TEXTURE_BUFFER);
+    if (buffer == 0 || origin_buffer == 0) {
+        LOG_ERROR("Failed to grow the vertex pool to %zu vertices", capacity);
+        if (buffer) {
+            buffer_destroy(&buffer);
+        }
+        if (origin_buffer) {
+            buffer_destroy(&origin_buffer);
+        }
+        return -1;
+    }
+
+    if (free_list_insert(pool, pool->capacity, capacity - pool->capacity) != 0) {
+        buffer_destroy(&buffer);
+        buffer_destroy(&origin_buffer);
+        return -1;
+    }
+
+    buffer_copy_sub_data(pool->vertex_buffer, buffer, 0, 0, pool->capacity * pool->layout.stride);
+    buffer_destroy(&pool->vertex_buffer);
+    pool->vertex_buffer = buffer;
+    set_attributes(pool);
+
+    buffer_copy_sub_data(pool->origin_buffer, origin_buffer, 0, 0, PAGES(pool->capacity) * sizeof(vec4s));
+    buffer_destroy(&pool->origin_buffer);
+    pool->origin_buffer = origin_buffer;
+    texture_set_buffer(pool->origin_texture, pool->origin_buffer);
+
+    LOG_DEBUG("Vertex pool grown to %zu vertices", capacity);
+    pool->capacity = capacity;
+    return 0;
+}
+
+vertex_pool_t *vertex_pool_create(const vertex_layout_t *layout, size_t capacity) {
+    if (layout == NULL) {
+        LOG_ERROR("'vertex_pool_create' called with NULL layout");
+        return NULL;
+    }
+
+    if (capacity == 0) {
+        LOG_ERROR("'vertex_pool_create' called with 0 capacity");
+        return NULL;
+    }
+
+    vertex_pool_t *pool = calloc(1, sizeof(vertex_pool_t));
+    if (pool == NULL) {
+        LOG_ERROR("Failed to allocate vertex pool");
+        return NULL;
+    }
+
+    capacity       = PAGES(capacity) * VERTEX_POOL_PAGE_SIZE;
+    pool->layout   = *layout;
+    pool->capacity = capacity;
+    if (free_list_insert(pool, 0, capacity) != 0) {
+        free(pool);
+        return NULL;
+    }
+
+    pool->vertex_array = vertex_array_create();
+    pool->vertex_buffer =
+        buffer_create(capacity * layout->stride, NULL, BUFFER_USAGE_DYNAMIC_DRAW, BUFFER_TARGET_ARRAY_BUFFER);
+    set_attributes(pool);
+
+    pool->origin_buffer  = buffer_create(PAGES(capacity) * sizeof(vec4s), NULL, BUFFER_USAGE_DYNAMIC_DRAW,
+                                         BUFFER_TARGET_TEXTURE_BUFFER);
+    pool->origin_texture = texture_create();
+    texture_set_buffer(pool->origin_texture, pool->origin_buffer);
+
+    return pool;
+}
+
+void vertex_pool_destroy(vertex_pool_t *pool) {
+    if (pool == NULL) {
+        LOG_ERROR("'vertex_pool_destroy' called with NULL pool");
+        return;
+    }
+
+    for (size_t i = 0; i < pool->allocation_count; ++i) {
+        pool->allocations[i]->pool  = NULL;
+        pool->allocations[i]->count = 0;
+    }
+
+    buffer_destroy(&pool->vertex_buffer);
+    buffer_destroy(&pool->origin_buffer);
+    texture_destroy(&pool->origin_texture);
+    vertex_array_destroy(&pool->vertex_array);
+    free(pool->free_ranges);
+    free(pool->allocations);
+    free(pool);
+}
+
+int vertex_pool_alloc(vertex_pool_t *pool, vertex_pool_allocation_t *allocation, size_t count) {
+    if (pool == NULL) {
+        LOG_ERROR("'vertex_pool_alloc' called with NULL pool");
+        return -1;
+    }
+
+    if (allocation == NULL) {
+        LOG_ERROR("'vertex_pool_alloc' called with NULL allocation");
+        return -1;
+    }
+
+    if (count == 0) {
+        LOG_ERROR("'vertex_pool_alloc' called with 0 count");
+        return -1;
+    }
+
+    count = PAGES(count) * VERTEX_POOL_PAGE_SIZE;
+    if (pool->allocation_count == pool->allocation_capacity) {
+        size_t capacity = pool->allocation_capacity ? pool->allocation_capacity * 2 : VERTEX_POOL_BASE_LIST_CAPACITY;
+        vertex_pool_allocation_t **allocations =
+            realloc(pool->allocations, capacity * sizeof(vertex_pool_allocation_t *));
+        if (allocations == NULL) {
+            LOG_ERROR("Failed to grow the vertex pool allocation list");
+            return -1;
+        }
+        pool->allocations         = allocations;
+        pool->allocation_capacity = capacity;
+    }
+
+    // First fit, growing the pool when no hole is large enough. The last hole ends the pool if it is free, growing
+    // only needs to cover the rest.
+    size_t hole = 0;
+    while (hole < pool->free_count && pool->free_ranges[hole].count < count) {
+        ++hole;
+    }
+
+    if (hole == pool->free_count) {
+        vertex_pool_range_t *last = pool->free_count > 0 ? &pool->free_ranges[pool->free_count - 1] : NULL;
+        size_t tail               = last && last->offset + last->count == pool->capacity ? last->count : 0;
+        if (grow(pool, count - tail) != 0) {
+            return -1;
+        }
+        hole = pool->free_count - 1;
+    }
+
+    allocation->pool   = pool;
+    allocation->offset = free_list_take(pool, hole, count);
+    allocation->count  = count;
+    allocation->origin = GLMS_VEC3_ZERO;
+    allocation->index  = pool->allocation_count;
+
+    pool->allocations[pool->allocation_count++] = allocation;
+    pool->used += count;
+    return 0;
+}
+
+void vertex_pool_free(vertex_pool_allocation_t *allocation) {
+    if (allocation == NULL) {
+        LOG_ERROR("'vertex_pool_free' called with NULL allocation");
+        return;
+    }
+
+    vertex_pool_t *pool = allocation->pool;
+    if (pool == NULL) {
+        return;
+    }
+
+    free_list_insert(pool, allocation->offset, allocation->count);
+    pool->used -= allocation->count;
+
+    vertex_pool_allocation_t *last = pool->allocations[--pool->allocation_count];
+    pool->allocations[allocation->index] = last;
+    last->index                          = allocation->index;
+
+    allocation->pool  = NULL;
+    allocation->count = 0;
+}
+
+void vertex_pool_upload(vertex_pool_allocation_t *allocation, size_t offset, const void *vertices, size_t count) {
+    if (allocation == NULL) {
+        LOG_ERROR("'vertex_pool_upload' called with NULL allocation");
+        return;
+    }
+
+    if (vertices == NULL) {
+        LOG_ERROR("'vertex_pool_upload' called with NULL vertices");
+        return;
+    }
+
+    if (allocation->pool == NULL || offset + count > allocation->count) {
+        LOG_ERROR("Vertex range %zu-%zu is out of the allocation bounds (%zu vertices)", offset, offset + count,
+                  allocation->count);
+        return;
+    }
+
+    size_t stride = allocation->pool->layout.stride;
+    buffer_sub_data(allocation->pool->vertex_buffer, BUFFER_TARGET_ARRAY_BUFFER, (allocation->offset + offset) * stride,
+                    count * stride, vertices);
+}
+
+int vertex_pool_upload_staged(vertex_pool_allocation_t *allocation, size_t offset, const void *vertices, size_t count,
+                              staging_ring_t *staging) {
+    if (allocation == NULL) {
+        LOG_ERROR("'vertex_pool_upload_staged' called with NULL allocation");
+        return -1;
+    }
+
+    if (vertices == NULL) {
+        LOG_ERROR("'vertex_pool_upload_staged' called with NULL vertices");
+        return -1;
+    }
+
+    if (allocation->pool == NULL || offset + count > allocation->count) {
+        LOG_ERROR("Vertex range %zu-%zu is out of the allocation bounds (%zu vertices)", offset, offset + count,
+                  allocation->count);
+        return -1;
+    }
+
+    size_t stride = allocation->pool->layout.stride;
+    return staging_ring_upload(staging, allocation->pool->vertex_buffer, (allocation->offset + offset) * stride,
+                               vertices, count * stride);
+}
+
+void vertex_pool_set_origin(vertex_pool_allocation_t *allocation, vec3s origin) {
+    if (allocation == NULL) {
+        LOG_ERROR("'vertex_pool_set_origin' called with NULL allocation");
+        return;
+    }
+
+    if (allocation->pool == NULL) {
+        LOG_ERROR("'vertex_pool_set_origin' called with unallocated allocation");
+        return;
+    }
+
+    allocation->origin = origin;
+    write_origins(allocation->pool, allocation);
+}
+
+size_t vertex_pool_defragment(vertex_pool_t *pool, size_t max_vertices) {
+    if (pool == NULL) {
+        LOG_ERROR("'vertex_pool_defragment' called with NULL pool");
+        return 0;
+    }
+
+    size_t moved = 0;
+    while (moved < max_vertices) {
+        // Highest allocation fitting the lowest hole it can move down into
+        vertex_pool_allocation_t *candidate = NULL;
+        size_t hole                         = 0;
+        for (; hole < pool->free_count; ++hole) {
+            vertex_pool_range_t range = pool->free_ranges[hole];
+            for (size_t i = 0; i < pool->allocation_count; ++i) {
+                vertex_pool_allocation_t *allocation = pool->allocations[i];
+                if (allocation->offset > range.offset && allocation->count <= range.count &&
+                    (candidate == NULL || allocation->offset > candidate->offset)) {
+                    candidate = allocation;
+                }
+            }
+
+            if (candidate) {
+                break;
+            }
+        }
+
+        if (candidate == NULL) {
+            break;
+        }
+
+        // Holes are merged with their neighbors, so the allocation starts past the end of the hole and the copy never
+        // overlaps itself
+        size_t stride = pool->layout.stride;
+        size_t from   = candidate->offset;
+        size_t to     = free_list_take(pool, hole, candidate->count);
+        buffer_copy_sub_data(pool->vertex_buffer, pool->vertex_buffer, from * stride, to * stride,
+                             candidate->count * stride);
+        free_list_insert(pool, from, candidate->count);
+
+        candidate->offset = to;
+        write_origins(pool, candidate);
+        moved += candidate->count;
+    }
+
+    return moved;
+}
+
+void vertex_pool_bind(vertex_pool_t *pool) {
+    if (pool == NULL) {
+        LOG_ERROR("'vertex_pool_bind' called with NULL pool");
+        return;
+    }
+
+    vertex_array_bind(pool->vertex_array);
+
+    // The quad index buffer keeps its ID when it grows, it only has to be attached to the vertex array once
+    uint32_t index_buffer = mesh_quad_indices_reserve(0);
+    if (index_buffer != pool->index_buffer) {
+        buffer_bind(index_buffer, BUFFER_TARGET_ELEMENT_ARRAY_BUFFER);
+        pool->index_buffer = index_buffer;
+    }
+
+    texture_bind_buffer(pool->origin_texture, VERTEX_POOL_ORIGIN_SLOT);
+}
+
+size_t vertex_pool_get_capacity(vertex_pool_t *pool) {
+    if (pool == NULL) {
+        LOG_ERROR("'vertex_pool_get_capacity' called with NULL pool");
+        return 0;
+    }
+    return pool->capacity;
+}
+
+size_t vertex_pool_get_used(vertex_pool_t *pool) {
+    if (pool == NULL) {
+        LOG_ERROR("'vertex_pool_get_used' called with NULL pool");
+        return 0;
+    }
+    return pool->used;
+}
@@ -3,6 +3,7 @@
 
 #include "core/file.h"
 #include "core/input.h"
+#include "core/job_system.h"
 #include "core/log.h"
 #include "core/profiling.h"
 #include "graphics/camera.h"
@@ -11,6 +12,7 @@
 #include "graphics/shader_program.h"
 #include "graphics/tilemap.h"
 #include "graphics/window.h"
+#include "world/block.h"
 #include "world/chunk.h"
 #include "world/world.h"
 #include "world/world_renderer.h"
@@ -18,6 +20,9 @@
 #define VERTEX_SHADER_PATH   "assets/shaders/main.vs"
 #define FRAGMENT_SHADER_PATH "assets/shaders/main.fs"
 
+#define BOUNDS_VERTEX_SHADER_PATH   "assets/shaders/bounds.vs"
+#define BOUNDS_FRAGMENT_SHADER_PATH "assets/shaders/bounds.fs"
+
 #define LOG_FILE EXECUTABLE_NAME ".log"
 
 static int is_running               = 0;
@@ -33,6 +38,58 @@ void key_callback(key_code_t key) {
     if (key == KEY_F1) {
         renderer_get_state()->wireframe = !renderer_get_state()->wireframe;
     }
+
+    if (key == KEY_F2) {
+        renderer_get_state()->occlusion_queries = !renderer_get_state()->occlusion_queries;
+        LOG_INFO("Occlusion queries %s", renderer_get_state()->occlusion_queries ? "enabled" : "disabled");
+    }
+
+    if (key == KEY_F3) {
+        gl_state_counters_t counters = renderer_get_state()->gl_state_counters;
+        LOG_INFO("GL binding calls last frame: %llu issued, %llu skipped", (unsigned long long)counters.issued,
+                 (unsigned long long)counters.skipped);
+    }
+}
+
+static char *read_shader_source(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        LOG_ERROR("Failed to open file: %s", path);
+        return NULL;
+    }
+
+    size_t size  = get_file_size(fp);
+    char *source = malloc(size);
+    read_file_content(fp, source, size);
+    fclose(fp);
+    return source;
+}
+
+static shader_program_t *load_shader_program(const char *vertex_path, const char *fragment_path) {
+    char *vertex_shader_source   = read_shader_source(vertex_path);
+    char *fragment_shader_source = read_shader_source(fragment_path);
+    if (!vertex_shader_source || !fragment_shader_source) {
+        free(vertex_shader_source);
+        free(fragment_shader_source);
+        return NULL;
+    }
+
+    uint32_t vertex_shader = shader_create(SHADER_TYPE_VERTEX, vertex_shader_source);
+    free(vertex_shader_source);
+
+    uint32_t fragment_shader = shader_create(SHADER_TYPE_FRAGMENT, fragment_shader_source);
+    free(fragment_shader_source);
+
+    shader_program_t *shader_program = shader_program_create();
+    if (shader_program) {
+        shader_program_attach_shader(shader_program, vertex_shader);
+        shader_program_attach_shader(shader_program, fragment_shader);
+        shader_program_link(shader_program);
+    }
+
+    shader_destroy(&vertex_shader);
+    shader_destroy(&fragment_shader);
+    return shader_program;
 }
 
 void mouse_callback(double x, double y) { camera_update_view(camera, (vec2s) {{x, y}}); }
@@ -106,46 +163,24 @@ int main(int argc, char **argv) {
 
     input_init();
 
-    FILE *fp = fopen(VERTEX_SHADER_PATH, "r");
-    if (!fp) {
-        LOG_FATAL("Failed to open file: %s", VERTEX_SHADER_PATH);
-        return 1;
-    }
-
-    size_t vertex_shader_size  = get_file_size(fp);
-    char *vertex_shader_source = malloc(vertex_shader_size);
-    read_file_content(fp, vertex_shader_source, vertex_shader_size);
-    fclose(fp);
-
-    fp = fopen(FRAGMENT_SHADER_PATH, "r");
-    if (!fp) {
-        LOG_FATAL("Failed to open file: %s", FRAGMENT_SHADER_PATH);
+    job_system_settings_t job_system_settings = {0};
+    result                                    = job_system_init(job_system_settings);
+    if (result) {
+        LOG_FATAL("Failed to initialize job system");
         return 1;
     }
 
-    size_t fragment_shader_size  = get_file_size(fp);
-    char *fragment_shader_source = malloc(fragment_shader_size);
-    read_file_content(fp, fragment_shader_source, fragment_shader_size);
-    fclose(fp);
-
-    uint32_t vertex_shader = shader_create(SHADER_TYPE_VERTEX, vertex_shader_source);
-    free(vertex_shader_source);
-
-    uint32_t fragment_shader = shader_create(SHADER_TYPE_FRAGMENT, fragment_shader_source);
-    free(fragment_shader_source);
-
-    shader_program_t *shader_program = shader_program_create();
+    shader_program_t *shader_program = load_shader_program(VERTEX_SHADER_PATH, FRAGMENT_SHADER_PATH);
     if (!shader_program) {
         LOG_FATAL("Failed to create shader program");
         return 1;
     }
 
-    shader_program_attach_shader(shader_program, vertex_shader);
-    shader_program_attach_shader(shader_program, fragment_shader);
-    shader_program_link(shader_program);
-
-    shader_destroy(&vertex_shader);
-    shader_destroy(&fragment_shader);
+    shader_program_t *bounds_shader = load_shader_program(BOUNDS_VERTEX_SHADER_PATH, BOUNDS_FRAGMENT_SHADER_PATH);
+    if (!bounds_shader) {
+        LOG_FATAL("Failed to create bounds shader program");
+        return 1;
+    }
 
     tilemap_t *tilemap = tilemap_load("assets/tilemaps/default.tilemap");
     if (!tilemap) {
@@ -153,6 +188,11 @@ int main(int argc, char **argv) {
         return 1;
     }
 
+    if (block_registry_load("assets/tilemaps/default.blocks")) {
+        LOG_FATAL("Failed to load block definitions");
+        return 1;
+    }
+
     camera_settings_t camera_settings = {0};
     camera_settings.sensitivity       = 0.002f;
     camera_settings.fov               = 45.0f;
@@ -169,7 +209,7 @@ int main(int argc, char **argv) {
     }
 
     camera = renderer_get_camera();
-    camera_set_position(camera, (vec3s) {{10.0f, 68.0f, 10.0f}});
+    camera_set_position(camera, (vec3s) {{10.0f, 120.0f, 10.0f}});
 
     input_set_cursor_enabled(0);
     input_add_key_pressed_callback(key_callback);
@@ -179,6 +219,8 @@ int main(int argc, char **argv) {
     world_renderer_settings.tilemap                   = tilemap;
     world_renderer_settings.block_shader              = shader_program;
     world_renderer_settings.draw_distance             = 6;
+    world_renderer_settings.mesh_mode                 = CHUNK_MESH_MODE_GREEDY;
+    world_renderer_settings.bounds_shader             = bounds_shader;
     world_renderer_t *world_renderer                  = world_renderer_create(world_renderer_settings);
     if (!world_renderer) {
         LOG_FATAL("Failed to create world renderer");
@@ -186,7 +228,8 @@ int main(int argc, char **argv) {
     }
 
     world_settings_t world_settings = {0};
-    world_settings.size             = 8;
+    world_settings.size             = 0;
+    world_settings.seed             = 1337;
     world_t *world                  = world_create(world_settings);
     if (!world) {
         LOG_FATAL("Failed to create world");
@@ -202,19 +245,31 @@ int main(int argc, char **argv) {
         window_update_delta_time();
         update();
 
+        // Finish the background jobs that landed since the last frame, e.g. uploading chunk meshes
+        int profile_id = profiling_begin("Main thread jobs");
+        if (job_system_run_main_thread_jobs()) {
+            profiling_end(profile_id);
+        } else {
+            profiling_cancel(profile_id);
+        }
+
         world_renderer_prepare(world_renderer, world);
 
         renderer_begin_frame();
 
-        world_renderer_render(world_renderer, world, camera_get_position(camera));
+        world_renderer_render(world_renderer, world, camera);
 
         renderer_end_frame();
     }
 
-    world_destroy(world);
+    // The renderer waits for its jobs in flight, which still reference live chunks
     world_renderer_destroy(world_renderer);
+    world_destroy(world);
+    job_system_deinit();
     shader_program_destroy(shader_program);
+    shader_program_destroy(bounds_shader);
     tilemap_free(tilemap);
+    block_registry_free();
 
     renderer_deinit();
     window_deinit();
@@ -1,123 +1,273 @@
 #include "world/block.h"
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "core/log.h"
 
-#define BLOCK_TILE_UNIFORM(BLOCK_ID, TILE_ID) \
-    case BLOCK_ID:                            \
-        for (int i = 0; i < 6; ++i) {         \
-            tiles.values[i] = TILE_ID;        \
-        }                                     \
-        break;
-
-#define U_MIN (((tile_id % tilemap->tile_size) / (float)tilemap->tile_size) + pixel_size)
-#define V_MIN ((tile_id / row_size) / (float)tilemap->tile_size + pixel_size)
-#define U_MAX ((((tile_id % tilemap->tile_size) + 1) / (float)tilemap->tile_size) - pixel_size)
-#define V_MAX ((((tile_id / row_size) + 1) / (float)tilemap->tile_size) - pixel_size)
-
-int block_is_opaque(block_id_t block) { return block != BLOCK_ID_AIR; }
-
-block_tiles_t block_get_tiles(block_id_t block) {
-    block_tiles_t tiles = {0};
-
-    switch (block) {
-        case BLOCK_ID_AIR:
-            break;
-            BLOCK_TILE_UNIFORM(BLOCK_ID_STONE, TILE_ID_STONE);
-            BLOCK_TILE_UNIFORM(BLOCK_ID_COBBLESTONE, TILE_ID_COBBLESTONE);
-            BLOCK_TILE_UNIFORM(BLOCK_ID_DIRT, TILE_ID_DIRT);
-        case BLOCK_ID_GRASS:
-            tiles.values[BLOCK_FACE_TOP]    = TILE_ID_GRASS_TOP;
-            tiles.values[BLOCK_FACE_BOTTOM] = TILE_ID_GRASS_BOTTOM;
-            for (int i = 2; i < 6; ++i) {
-                tiles.values[i] = TILE_ID_GRASS_SIDE;
-            }
-            break;
-    }
+block_registry_t block_registry = {0};
 
-    return tiles;
-}
+// Definition parsed from the block file, before being compiled into the registry tables
+typedef struct {
+    char *name;
+    uint8_t flags;
+    block_tiles_t tiles;
+} block_definition_t;
+
+block_tiles_t block_get_tiles(block_id_t block) { return block_registry.tiles[block_registry_index(block)]; }
+
+typedef struct {
+    int u_axis;
+    int v_axis;
+    int u_flip;
+    int v_flip;
+    ivec3s corners[4];
+} face_layout_t;
+
+// Corners are listed counter-clockwise when looking at the face from outside. The texture u coordinate runs along
+// `u_axis` and v along `v_axis`, flipped so that v always points down on side faces.
+static const face_layout_t face_layouts[6] = {
+    [BLOCK_FACE_TOP]    = {0, 2, 0, 0, {{{1, 1, 1}}, {{1, 1, 0}}, {{0, 1, 0}}, {{0, 1, 1}}}},
+    [BLOCK_FACE_BOTTOM] = {0, 2, 0, 0, {{{0, 0, 1}}, {{0, 0, 0}}, {{1, 0, 0}}, {{1, 0, 1}}}},
+    [BLOCK_FACE_FRONT]  = {0, 1, 0, 1, {{{1, 0, 1}}, {{1, 1, 1}}, {{0, 1, 1}}, {{0, 0, 1}}}},
+    [BLOCK_FACE_BACK]   = {0, 1, 0, 1, {{{0, 0, 0}}, {{0, 1, 0}}, {{1, 1, 0}}, {{1, 0, 0}}}},
+    [BLOCK_FACE_LEFT]   = {2, 1, 1, 1, {{{0, 0, 1}}, {{0, 1, 1}}, {{0, 1, 0}}, {{0, 0, 0}}}},
+    [BLOCK_FACE_RIGHT]  = {2, 1, 0, 1, {{{1, 0, 0}}, {{1, 1, 0}}, {{1, 1, 1}}, {{1, 0, 1}}}},
+};
+
+int block_face_u_axis(block_face_t face) { return face_layouts[face].u_axis; }
+
+int block_face_v_axis(block_face_t face) { return face_layouts[face].v_axis; }
 
-void block_get_faces(block_id_t block, vec3s position, tilemap_t *tilemap, block_faces_t *faces) {
-    if (tilemap == NULL) {
-        LOG_ERROR("'block_get_faces' called with NULL tilemap");
+void block_get_face(block_id_t block, block_face_t face, ivec3s position, ivec2s size, block_face_data_t *data) {
+    if (data == NULL) {
+        LOG_ERROR("'block_get_face' called with NULL data");
         return;
     }
 
+    const face_layout_t *layout = &face_layouts[face];
+    tile_id_t tile_id           = block_get_tiles(block).values[face];
+
+    for (int i = 0; i < 4; ++i) {
+        ivec3s corner = layout->corners[i];
+        int u         = corner.raw[layout->u_axis];
+        int v         = corner.raw[layout->v_axis];
+
+        corner.raw[layout->u_axis] *= size.x;
+        corner.raw[layout->v_axis] *= size.y;
+
+        data->vertices[i].position =
+            CHUNK_VERTEX_PACK_POSITION(position.x + corner.x, position.y + corner.y, position.z + corner.z);
+        data->vertices[i].texture = CHUNK_VERTEX_PACK_TEXTURE(tile_id, (layout->u_flip ? 1 - u : u) * size.x,
+                                                              (layout->v_flip ? 1 - v : v) * size.y);
+    }
+}
+
+void block_get_faces(block_id_t block, ivec3s position, block_faces_t *faces) {
     if (faces == NULL) {
         LOG_ERROR("'block_get_faces' called with NULL faces");
         return;
     }
 
-    block_tiles_t tiles = block_get_tiles(block);
-
-    // Tilemap parameters
-    float pixel_size = 1.0f / tilemap->map_size;
-    int row_size     = tilemap->map_size / tilemap->tile_size;
-    tile_id_t tile_id;
-
-    // Top face
-    tile_id = tiles.values[BLOCK_FACE_TOP];
-    faces->values[BLOCK_FACE_TOP].vertices[0] =
-        (vertex_t) {glms_vec3_add((vec3s) {{1.0f, 1.0f, 1.0f}}, position), (vec2s) {{U_MAX, V_MAX}}};
-    faces->values[BLOCK_FACE_TOP].vertices[1] =
-        (vertex_t) {glms_vec3_add((vec3s) {{1.0f, 1.0f, 0.0f}}, position), (vec2s) {{U_MAX, V_MIN}}};
-    faces->values[BLOCK_FACE_TOP].vertices[2] =
-        (vertex_t) {glms_vec3_add((vec3s) {{0.0f, 1.0f, 0.0f}}, position), (vec2s) {{U_MIN, V_MIN}}};
-    faces->values[BLOCK_FACE_TOP].vertices[3] =
-        (vertex_t) {glms_vec3_add((vec3s) {{0.0f, 1.0f, 1.0f}}, position), (vec2s) {{U_MIN, V_MAX}}};
-
-    // Bottom face
-    tile_id = tiles.values[BLOCK_FACE_BOTTOM];
-    faces->values[BLOCK_FACE_BOTTOM].vertices[0] =
-        (vertex_t) {glms_vec3_add((vec3s) {{0.0f, 0.0f, 1.0f}}, position), (vec2s) {{U_MIN, V_MAX}}};
-    faces->values[BLOCK_FACE_BOTTOM].vertices[1] =
-        (vertex_t) {glms_vec3_add((vec3s) {{0.0f, 0.0f, 0.0f}}, position), (vec2s) {{U_MIN, V_MIN}}};
-    faces->values[BLOCK_FACE_BOTTOM].vertices[2] =
-        (vertex_t) {glms_vec3_add((vec3s) {{1.0f, 0.0f, 0.0f}}, position), (vec2s) {{U_MAX, V_MIN}}};
-    faces->values[BLOCK_FACE_BOTTOM].vertices[3] =
-        (vertex_t) {glms_vec3_add((vec3s) {{1.0f, 0.0f, 1.0f}}, position), (vec2s) {{U_MAX, V_MAX}}};
-
-    // Front face
-    tile_id = tiles.values[BLOCK_FACE_FRONT];
-    faces->values[BLOCK_FACE_FRONT].vertices[0] =
-        (vertex_t) {glms_vec3_add((vec3s) {{1.0f, 0.0f, 1.0f}}, position), (vec2s) {{U_MAX, V_MAX}}};
-    faces->values[BLOCK_FACE_FRONT].vertices[1] =
-        (vertex_t) {glms_vec3_add((vec3s) {{1.0f, 1.0f, 1.0f}}, position), (vec2s) {{U_MAX, V_MIN}}};
-    faces->values[BLOCK_FACE_FRONT].vertices[2] =
-        (vertex_t) {glms_vec3_add((vec3s) {{0.0f, 1.0f, 1.0f}}, position), (vec2s) {{U_MIN, V_MIN}}};
-    faces->values[BLOCK_FACE_FRONT].vertices[3] =
-        (vertex_t) {glms_vec3_add((vec3s) {{0.0f, 0.0f, 1.0f}}, position), (vec2s) {{U_MIN, V_MAX}}};
-
-    // Back face
-    tile_id = tiles.values[BLOCK_FACE_BACK];
-    faces->values[BLOCK_FACE_BACK].vertices[0] =
-        (vertex_t) {glms_vec3_add((vec3s) {{0.0f, 0.0f, 0.0f}}, position), (vec2s) {{U_MIN, V_MAX}}};
-    faces->values[BLOCK_FACE_BACK].vertices[1] =
-        (vertex_t) {glms_vec3_add((vec3s) {{0.0f, 1.0f, 0.0f}}, position), (vec2s) {{U_MIN, V_MIN}}};
-    faces->values[BLOCK_FACE_BACK].vertices[2] =
-        (vertex_t) {glms_vec3_add((vec3s) {{1.0f, 1.0f, 0.0f}}, position), (vec2s) {{U_MAX, V_MIN}}};
-    faces->values[BLOCK_FACE_BACK].vertices[3] =
-        (vertex_t) {glms_vec3_add((vec3s) {{1.0f, 0.0f, 0.0f}}, position), (vec2s) {{U_MAX, V_MAX}}};
-
-    // Left face
-    tile_id = tiles.values[BLOCK_FACE_LEFT];
-    faces->values[BLOCK_FACE_LEFT].vertices[0] =
-        (vertex_t) {glms_vec3_add((vec3s) {{0.0f, 0.0f, 1.0f}}, position), (vec2s) {{U_MIN, V_MAX}}};
-    faces->values[BLOCK_FACE_LEFT].vertices[1] =
-        (vertex_t) {glms_vec3_add((vec3s) {{0.0f, 1.0f, 1.0f}}, position), (vec2s) {{U_MIN, V_MIN}}};
-    faces->values[BLOCK_FACE_LEFT].vertices[2] =
-        (vertex_t) {glms_vec3_add((vec3s) {{0.0f, 1.0f, 0.0f}}, position), (vec2s) {{U_MAX, V_MIN}}};
-    faces->values[BLOCK_FACE_LEFT].vertices[3] =
-        (vertex_t) {glms_vec3_add((vec3s) {{0.0f, 0.0f, 0.0f}}, position), (vec2s) {{U_MAX, V_MAX}}};
-
-    // Right face
-    tile_id = tiles.values[BLOCK_FACE_RIGHT];
-    faces->values[BLOCK_FACE_RIGHT].vertices[0] =
-        (vertex_t) {glms_vec3_add((vec3s) {{1.0f, 0.0f, 0.0f}}, position), (vec2s) {{U_MIN, V_MAX}}};
-    faces->values[BLOCK_FACE_RIGHT].vertices[1] =
-        (vertex_t) {glms_vec3_add((vec3s) {{1.0f, 1.0f, 0.0f}}, position), (vec2s) {{U_MIN, V_MIN}}};
-    faces->values[BLOCK_FACE_RIGHT].vertices[2] =
-        (vertex_t) {glms_vec3_add((vec3s) {{1.0f, 1.0f, 1.0f}}, position), (vec2s) {{U_MAX, V_MIN}}};
-    faces->values[BLOCK_FACE_RIGHT].vertices[3] =
-        (vertex_t) {glms_vec3_add((vec3s) {{1.0f, 0.0f, 1.0f}}, position), (vec2s) {{U_MAX, V_MAX}}};
-}
\ No newline at end of file
+    for (int face = 0; face < 6; ++face) {
+        block_get_face(block, face, position, (ivec2s) {{1, 1}}, &faces->values[face]);
+    }
+}
+
+static int parse_flags(const char *line, uint8_t *flags) {
+    char flag[32];
+    int length = 0;
+    while (sscanf(line, "%31s%n", flag, &length) == 1) {
+        if (strcmp(flag, "opaque") == 0) {
+            *flags |= BLOCK_FLAG_OPAQUE;
+        } else {
+            LOG_ERROR("Unknown block flag: %s", flag);
+            return -1;
+        }
+        line += length;
+    }
+    return 0;
+}
+
+static int parse_tiles(const char *line, block_tiles_t *tiles) {
+    int values[6];
+    int count = sscanf(line, "%d %d %d %d %d %d", &values[0], &values[1], &values[2], &values[3], &values[4],
+                       &values[5]);
+    if (count != 1 && count != 6) {
+        LOG_ERROR("Expected 1 or 6 tiles, got %d", count);
+        return -1;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        if (values[i] < 0 || values[i] > TILE_ID_MAX) {
+            LOG_ERROR("Tile %d is out of range, expected 0 to %d", values[i], TILE_ID_MAX);
+            return -1;
+        }
+    }
+
+    for (int face = 0; face < 6; ++face) {
+        tiles->values[face] = values[count == 1 ? 0 : face];
+    }
+    return 0;
+}
+
+// Compiles the parsed definitions into the registry tables
+static int compile_registry(block_definition_t *definitions, size_t count) {
+    block_registry_t registry = {0};
+    registry.count            = count;
+    registry.names            = calloc(count, sizeof(char *));
+    registry.opaque           = calloc((BLOCK_ID_MAX + 1) / 64, sizeof(uint64_t));
+    registry.flags            = calloc(count, sizeof(uint8_t));
+    registry.tiles            = calloc(count, sizeof(block_tiles_t));
+    registry.face_templates   = calloc(count, sizeof(block_faces_t));
+    if (!registry.names || !registry.opaque || !registry.flags || !registry.tiles || !registry.face_templates) {
+        LOG_ERROR("Failed to allocate the block registry");
+        free(registry.names);
+        free(registry.opaque);
+        free(registry.flags);
+        free(registry.tiles);
+        free(registry.face_templates);
+        return -1;
+    }
+
+    for (size_t id = 0; id < count; ++id) {
+        block_definition_t *definition = &definitions[id];
+        registry.names[id]             = definition->name;
+        registry.flags[id]             = definition->flags;
+        registry.tiles[id]             = definition->tiles;
+        if (definition->flags & BLOCK_FLAG_OPAQUE) {
+            registry.opaque[id / 64] |= 1ull << (id % 64);
+        }
+        definition->name = NULL;
+    }
+
+    block_registry_free();
+    block_registry = registry;
+
+    // Face templates are built from the registered tiles, so they go last
+    for (size_t id = 0; id < count; ++id) {
+        block_get_faces(id, (ivec3s) {{0, 0, 0}}, &block_registry.face_templates[id]);
+    }
+    return 0;
+}
+
+int block_registry_load(const char *filename) {
+    FILE *file = fopen(filename, "r");
+    if (!file) {
+        LOG_ERROR("Failed to open file: %s", filename);
+        return -1;
+    }
+
+    block_definition_t *definitions = calloc(BLOCK_ID_MAX + 1, sizeof(block_definition_t));
+    if (definitions == NULL) {
+        LOG_ERROR("Failed to allocate block definitions");
+        fclose(file);
+        return -1;
+    }
+
+    for (int id = 0; id <= BLOCK_ID_MAX; ++id) {
+        for (int face = 0; face < 6; ++face) {
+            definitions[id].tiles.values[face] = TILE_ID_NONE;
+        }
+    }
+
+    size_t count                   = 0;
+    block_definition_t *definition = NULL;
+    int line_number                = 0;
+    int result                     = 0;
+
+    char line[256];
+    while (result == 0 && fgets(line, sizeof(line), file)) {
+        ++line_number;
+
+        char key[16];
+        int length = 0;
+        if (sscanf(line, "%15s%n", key, &length) != 1 || key[0] == '#') {
+            continue;
+        }
+
+        if (strcmp(key, "block") == 0) {
+            unsigned int id;
+            char name[64];
+            if (sscanf(line + length, "%u %63s", &id, name) != 2 || id > BLOCK_ID_MAX) {
+                LOG_ERROR("%s:%d: expected 'block <id> <name>'", filename, line_number);
+                result = -1;
+                break;
+            }
+
+            definition = &definitions[id];
+            if (definition->name) {
+                LOG_ERROR("%s:%d: block id %u is already defined as '%s'", filename, line_number, id, definition->name);
+                result = -1;
+                break;
+            }
+
+            definition->name = strdup(name);
+            if (id + 1 > count) {
+                count = id + 1;
+            }
+        } else if (definition == NULL) {
+            LOG_ERROR("%s:%d: '%s' outside of a block definition", filename, line_number, key);
+            result = -1;
+        } else if (strcmp(key, "flags") == 0) {
+            result = parse_flags(line + length, &definition->flags);
+        } else if (strcmp(key, "tiles") == 0) {
+            result = parse_tiles(line + length, &definition->tiles);
+        } else {
+            LOG_ERROR("%s:%d: unknown key '%s'", filename, line_number, key);
+            result = -1;
+        }
+    }
+
+    fclose(file);
+
+    if (result == 0 && count == 0) {
+        LOG_ERROR("%s: no blocks defined", filename);
+        result = -1;
+    }
+
+    // Opaque blocks are meshed, every face needs a tile
+    for (size_t id = 0; result == 0 && id < count; ++id) {
+        if ((definitions[id].flags & BLOCK_FLAG_OPAQUE) && definitions[id].tiles.values[0] == TILE_ID_NONE) {
+            LOG_ERROR("%s: opaque block '%s' has no tiles", filename, definitions[id].name);
+            result = -1;
+        }
+    }
+
+    if (result == 0) {
+        result = compile_registry(definitions, count);
+    }
+
+    for (int id = 0; id <= BLOCK_ID_MAX; ++id) {
+        free(definitions[id].name);
+    }
+    free(definitions);
+
+    if (result == 0) {
+        LOG_INFO("Loaded %zu block types from %s", count, filename);
+    }
+    return result;
+}
+
+void block_registry_free() {
+    for (size_t id = 0; id < block_registry.count; ++id) {
+        free(block_registry.names[id]);
+    }
+
+    free(block_registry.names);
+    free(block_registry.opaque);
+    free(block_registry.flags);
+    free(block_registry.tiles);
+    free(block_registry.face_templates);
+    memset(&block_registry, 0, sizeof(block_registry));
+}
+
+block_id_t block_registry_find(const char *name) {
+    for (size_t id = 0; id < block_registry.count; ++id) {
+        if (block_registry.names[id] && strcmp(block_registry.names[id], name) == 0) {
+            return id;
+        }
+    }
+    return BLOCK_ID_AIR;
+}
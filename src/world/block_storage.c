@@ -0,0 +1,324 @@
+#include "world/block_storage.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/log.h"
+
+#define WORD_BITS 64
+
+static size_t word_count(size_t volume, uint32_t bits) { return (volume * bits + WORD_BITS - 1) / WORD_BITS; }
+
+static uint32_t read_index(const uint64_t *data, uint32_t bits, size_t index) {
+    size_t bit = index * bits;
+    return (data[bit / WORD_BITS] >> (bit % WORD_BITS)) & ((1ull << bits) - 1);
+}
+
+static void write_index(uint64_t *data, uint32_t bits, size_t index, uint32_t value) {
+    size_t bit     = index * bits;
+    uint64_t mask  = ((1ull << bits) - 1) << (bit % WORD_BITS);
+    uint64_t *word = &data[bit / WORD_BITS];
+    *word          = (*word & ~mask) | ((uint64_t)value << (bit % WORD_BITS));
+}
+
+// Smallest supported index width able to address the given number of palette entries
+static uint32_t bits_for_palette(uint32_t palette_size) {
+    uint32_t bits = 0;
+    while ((1u << bits) < palette_size) {
+        bits = bits ? bits * 2 : 1;
+    }
+    return bits;
+}
+
+static int repack(block_storage_t *storage, uint32_t bits, const uint32_t *remap) {
+    uint64_t *data = NULL;
+    if (bits > 0) {
+        data = calloc(word_count(storage->volume, bits), sizeof(uint64_t));
+        if (data == NULL) {
+            LOG_ERROR("Failed to allocate block storage data");
+            return -1;
+        }
+
+        if (storage->bits > 0) {
+            for (size_t i = 0; i < storage->volume; ++i) {
+                uint32_t value = read_index(storage->data, storage->bits, i);
+                write_index(data, bits, i, remap ? remap[value] : value);
+            }
+        }
+    }
+
+    block_id_t *palette = realloc(storage->palette, (1u << bits) * sizeof(block_id_t));
+    if (palette == NULL) {
+        LOG_ERROR("Failed to allocate block storage palette");
+        free(data);
+        return -1;
+    }
+
+    free(storage->data);
+    storage->palette = palette;
+    storage->data    = data;
+    storage->bits    = bits;
+    return 0;
+}
+
+int block_storage_init(block_storage_t *storage, size_t volume, block_id_t fill) {
+    if (storage == NULL) {
+        LOG_ERROR("'block_storage_init' called with NULL storage");
+        return -1;
+    }
+
+    storage->palette = malloc(sizeof(block_id_t));
+    if (storage->palette == NULL) {
+        LOG_ERROR("Failed to allocate block storage palette");
+        return -1;
+    }
+
+    storage->palette[0]   = fill;
+    storage->palette_size = 1;
+    storage->bits         = 0;
+    storage->data         = NULL;
+    storage->volume       = volume;
+    return 0;
+}
+
+int block_storage_copy(block_storage_t *storage, const block_storage_t *source) {
+    if (storage == NULL) {
+        LOG_ERROR("'block_storage_copy' called with NULL storage");
+        return -1;
+    }
+
+    if (source == NULL) {
+        LOG_ERROR("'block_storage_copy' called with NULL source");
+        return -1;
+    }
+
+    size_t palette_bytes = (1u << source->bits) * sizeof(block_id_t);
+    size_t data_bytes    = word_count(source->volume, source->bits) * sizeof(uint64_t);
+
+    storage->palette = malloc(palette_bytes);
+    storage->data    = data_bytes ? malloc(data_bytes) : NULL;
+    if (storage->palette == NULL || (data_bytes && storage->data == NULL)) {
+        LOG_ERROR("Failed to allocate block storage copy");
+        free(storage->palette);
+        free(storage->data);
+        return -1;
+    }
+
+    memcpy(storage->palette, source->palette, source->palette_size * sizeof(block_id_t));
+    if (data_bytes) {
+        memcpy(storage->data, source->data, data_bytes);
+    }
+
+    storage->palette_size = source->palette_size;
+    storage->bits         = source->bits;
+    storage->volume       = source->volume;
+    return 0;
+}
+
+void block_storage_free(block_storage_t *storage) {
+    if (storage == NULL) {
+        LOG_ERROR("'block_storage_free' called with NULL storage");
+        return;
+    }
+
+    free(storage->palette);
+    free(storage->data);
+    storage->palette      = NULL;
+    storage->data         = NULL;
+    storage->palette_size = 0;
+    storage->bits         = 0;
+}
+
+block_id_t block_storage_get(const block_storage_t *storage, size_t index) {
+    if (storage->bits == 0) {
+        return storage->palette[0];
+    }
+
+    return storage->palette[read_index(storage->data, storage->bits, index)];
+}
+
+void block_storage_unpack(const block_storage_t *storage, block_id_t *blocks) {
+    if (storage->bits == 0) {
+        for (size_t i = 0; i < storage->volume; ++i) {
+            blocks[i] = storage->palette[0];
+        }
+        return;
+    }
+
+    // Indices never straddle words, so decode one word at a time
+    size_t per_word = WORD_BITS / storage->bits;
+    uint64_t mask   = (1ull << storage->bits) - 1;
+    for (size_t i = 0, word = 0; i < storage->volume; ++word) {
+        uint64_t bits = storage->data[word];
+        for (size_t j = 0; j < per_word && i < storage->volume; ++j, ++i) {
+            blocks[i] = storage->palette[bits & mask];
+            bits >>= storage->bits;
+        }
+    }
+}
+
+// Position of a block in the palette, or `palette_size` if it is missing. `hint` is checked first.
+static uint32_t find_palette_index(const block_storage_t *storage, block_id_t block, uint32_t hint) {
+    if (hint < storage->palette_size && storage->palette[hint] == block) {
+        return hint;
+    }
+
+    uint32_t index = 0;
+    while (index < storage->palette_size && storage->palette[index] != block) {
+        ++index;
+    }
+    return index;
+}
+
+int block_storage_pack(block_storage_t *storage, const block_id_t *blocks) {
+    if (storage == NULL) {
+        LOG_ERROR("'block_storage_pack' called with NULL storage");
+        return -1;
+    }
+
+    if (blocks == NULL) {
+        LOG_ERROR("'block_storage_pack' called with NULL blocks");
+        return -1;
+    }
+
+    if (block_storage_fill(storage, blocks[0]) != 0) {
+        return -1;
+    }
+
+    // Collect the palette first so the indices are written once at their final width
+    uint32_t hint = 0;
+    for (size_t i = 1; i < storage->volume; ++i) {
+        hint = find_palette_index(storage, blocks[i], hint);
+        if (hint < storage->palette_size) {
+            continue;
+        }
+
+        if (storage->palette_size == 1u << BLOCK_STORAGE_MAX_BITS) {
+            LOG_ERROR("Block storage palette is full");
+            return -1;
+        }
+
+        block_id_t *palette = realloc(storage->palette, (storage->palette_size + 1) * sizeof(block_id_t));
+        if (palette == NULL) {
+            LOG_ERROR("Failed to allocate block storage palette");
+            return -1;
+        }
+        storage->palette                          = palette;
+        storage->palette[storage->palette_size++] = blocks[i];
+    }
+
+    if (storage->palette_size == 1) {
+        return 0;
+    }
+
+    if (repack(storage, bits_for_palette(storage->palette_size), NULL) != 0) {
+        return -1;
+    }
+
+    // Indices never straddle words, so encode one word at a time
+    size_t per_word = WORD_BITS / storage->bits;
+    hint            = 0;
+    for (size_t i = 0, word = 0; i < storage->volume; ++word) {
+        uint64_t bits = 0;
+        for (size_t j = 0; j < per_word && i < storage->volume; ++j, ++i) {
+            hint = find_palette_index(storage, blocks[i], hint);
+            bits |= (uint64_t)hint << (j * storage->bits);
+        }
+        storage->data[word] = bits;
+    }
+
+    return 0;
+}
+
+void block_storage_set(block_storage_t *storage, size_t index, block_id_t block) {
+    uint32_t palette_index = 0;
+    while (palette_index < storage->palette_size && storage->palette[palette_index] != block) {
+        ++palette_index;
+    }
+
+    if (palette_index == storage->palette_size) {
+        if (storage->palette_size == (1u << storage->bits)) {
+            // Stale entries may be hogging the palette, try to reclaim them before widening
+            if (storage->bits == BLOCK_STORAGE_MAX_BITS) {
+                block_storage_compact(storage);
+                if (storage->palette_size == (1u << storage->bits)) {
+                    LOG_ERROR("Block storage palette is full");
+                    return;
+                }
+            }
+
+            if (storage->palette_size == (1u << storage->bits) &&
+                repack(storage, storage->bits ? storage->bits * 2 : 1, NULL) != 0) {
+                return;
+            }
+        }
+
+        palette_index                             = storage->palette_size;
+        storage->palette[storage->palette_size++] = block;
+    }
+
+    if (storage->bits > 0) {
+        write_index(storage->data, storage->bits, index, palette_index);
+    }
+}
+
+int block_storage_fill(block_storage_t *storage, block_id_t block) {
+    block_id_t *palette = realloc(storage->palette, sizeof(block_id_t));
+    if (palette == NULL) {
+        LOG_ERROR("Failed to allocate block storage palette");
+        return -1;
+    }
+
+    free(storage->data);
+    storage->palette      = palette;
+    storage->data         = NULL;
+    storage->bits         = 0;
+    storage->palette_size = 1;
+    storage->palette[0]   = block;
+    return 0;
+}
+
+void block_storage_compact(block_storage_t *storage) {
+    if (storage->bits == 0) {
+        return;
+    }
+
+    uint32_t *remap = calloc(storage->palette_size, sizeof(uint32_t));
+    if (remap == NULL) {
+        LOG_ERROR("Failed to allocate block storage remap table");
+        return;
+    }
+
+    for (size_t i = 0; i < storage->volume; ++i) {
+        remap[read_index(storage->data, storage->bits, i)] = 1;
+    }
+
+    block_id_t *palette = malloc(storage->palette_size * sizeof(block_id_t));
+    if (palette == NULL) {
+        LOG_ERROR("Failed to allocate block storage palette");
+        free(remap);
+        return;
+    }
+
+    uint32_t palette_size = 0;
+    for (uint32_t i = 0; i < storage->palette_size; ++i) {
+        if (remap[i]) {
+            palette[palette_size] = storage->palette[i];
+            remap[i]              = palette_size++;
+        }
+    }
+
+    if (palette_size == 1) {
+        block_storage_fill(storage, palette[0]);
+    } else if (repack(storage, bits_for_palette(palette_size), remap) == 0) {
+        memcpy(storage->palette, palette, palette_size * sizeof(block_id_t));
+        storage->palette_size = palette_size;
+    }
+
+    free(palette);
+    free(remap);
+}
+
+size_t block_storage_memory_usage(const block_storage_t *storage) {
+    return (1u << storage->bits) * sizeof(block_id_t) + word_count(storage->volume, storage->bits) * sizeof(uint64_t);
+}
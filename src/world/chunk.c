@@ -6,79 +6,90 @@
 
 #include "core/log.h"
 #include "graphics/buffer.h"
+#include "graphics/mesh.h"
+#include "graphics/occlusion_query.h"
 #include "graphics/vertex_array.h"
+#include "world/chunk_mesher.h"
+#include "world/chunk_visibility.h"
 
-static int should_render_face(chunk_t *chunk, block_face_t face, ivec3s position, chunk_t **neighbors) {
-    ivec3s adjacent_position;
+static int section_is_full(chunk_t *chunk, int section) {
+    return chunk != NULL && section >= 0 && section < CHUNK_SECTION_COUNT && chunk->sections[section].full;
+}
 
-    block_id_t block = -1;
+// A full section only has visible faces if one of the six sections around it lets light in
+static int section_is_buried(chunk_t *chunk, int section, chunk_t **neighbors) {
+    return section_is_full(chunk, section) && section_is_full(chunk, section + 1) &&
+           section_is_full(chunk, section - 1) && section_is_full(neighbors[CHUNK_NEIGHBOR_FRONT], section) &&
+           section_is_full(neighbors[CHUNK_NEIGHBOR_BACK], section) &&
+           section_is_full(neighbors[CHUNK_NEIGHBOR_LEFT], section) &&
+           section_is_full(neighbors[CHUNK_NEIGHBOR_RIGHT], section);
+}
 
-    switch (face) {
-        case BLOCK_FACE_TOP:
-            adjacent_position = (ivec3s) {{position.x, position.y + 1, position.z}};
-            if (adjacent_position.y >= CHUNK_HEIGHT) {
-                return 1;
-            }
-            break;
-        case BLOCK_FACE_BOTTOM:
-            adjacent_position = (ivec3s) {{position.x, position.y - 1, position.z}};
-            if (adjacent_position.y < 0) {
-                return 1;
-            }
-            break;
-        case BLOCK_FACE_FRONT:
-            adjacent_position = (ivec3s) {{position.x, position.y, position.z + 1}};
-            if (adjacent_position.z >= CHUNK_SIZE) {
-                if (neighbors[CHUNK_NEIGHBOR_FRONT] == NULL) {
-                    return 1;
-                }
-                block = chunk_get_block(neighbors[CHUNK_NEIGHBOR_FRONT], (ivec3s) {{position.x, position.y, 0}});
-            }
-            break;
-        case BLOCK_FACE_BACK:
-            adjacent_position = (ivec3s) {{position.x, position.y, position.z - 1}};
-            if (adjacent_position.z < 0) {
-                if (neighbors[CHUNK_NEIGHBOR_BACK] == NULL) {
-                    return 1;
-                }
-                block = chunk_get_block(neighbors[CHUNK_NEIGHBOR_BACK],
-                                        (ivec3s) {{position.x, position.y, CHUNK_SIZE - 1}});
-            }
-            break;
-        case BLOCK_FACE_LEFT:
-            adjacent_position = (ivec3s) {{position.x - 1, position.y, position.z}};
-            if (adjacent_position.x < 0) {
-                if (neighbors[CHUNK_NEIGHBOR_LEFT] == NULL) {
-                    return 1;
-                }
-                block = chunk_get_block(neighbors[CHUNK_NEIGHBOR_LEFT],
-                                        (ivec3s) {{CHUNK_SIZE - 1, position.y, position.z}});
-            }
-            break;
-        case BLOCK_FACE_RIGHT:
-            adjacent_position = (ivec3s) {{position.x + 1, position.y, position.z}};
-            if (adjacent_position.x >= CHUNK_SIZE) {
-                if (neighbors[CHUNK_NEIGHBOR_RIGHT] == NULL) {
-                    return 1;
-                }
-                block = chunk_get_block(neighbors[CHUNK_NEIGHBOR_RIGHT], (ivec3s) {{0, position.y, position.z}});
-            }
-            break;
+// Builds a section into `vertices` and pads the rest of its slot with degenerate quads
+static size_t build_section_slot(chunk_t *chunk, int section, chunk_t **neighbors, chunk_mesh_mode_t mode,
+                                 chunk_vertex_t *vertices, size_t *capacity) {
+    size_t vertex_count = 0;
+    if (!chunk->sections[section].empty && !section_is_buried(chunk, section, neighbors)) {
+        vertex_count = chunk_mesher_build_section(chunk, section, neighbors, mode, vertices);
     }
 
-    if (block == -1) {
-        block = chunk_get_block(chunk, adjacent_position);
+    if (*capacity == 0) {
+        *capacity = CHUNK_SECTION_VERTEX_CAPACITY(vertex_count);
     }
 
-    return !block_is_opaque(block);
+    if (vertex_count <= *capacity) {
+        memset(&vertices[vertex_count], 0, (*capacity - vertex_count) * sizeof(chunk_vertex_t));
+    }
+    return vertex_count;
 }
 
 chunk_t *chunk_create(ivec2s position) {
-    chunk_t *chunk  = malloc(sizeof(chunk_t));
-    chunk->position = position;
-    chunk->blocks   = malloc(CHUNK_VOLUME * sizeof(block_id_t));
-    chunk->mesh     = mesh_create(NULL, 0, NULL, 0, NULL, -1);
-    chunk->dirty    = 1;
+    chunk_t *chunk = malloc(sizeof(chunk_t));
+
+    for (int i = 0; i < CHUNK_SECTION_COUNT; ++i) {
+        chunk_section_t *section = &chunk->sections[i];
+        if (block_storage_init(&section->blocks, CHUNK_SECTION_VOLUME, BLOCK_ID_AIR) != 0) {
+            while (i-- > 0) {
+                block_storage_free(&chunk->sections[i].blocks);
+            }
+            free(chunk);
+            return NULL;
+        }
+
+        section->opaque_count    = 0;
+        section->empty           = 1;
+        section->full            = 0;
+        section->dirty           = 1;
+        section->vertex_offset   = 0;
+        section->vertex_count    = 0;
+        section->vertex_capacity = 0;
+        section->index_offset    = 0;
+        section->index_count     = 0;
+        section->visibility      = CHUNK_VISIBILITY_ALL;
+        section->visit_frame     = 0;
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        chunk->neighbors[i] = NULL;
+    }
+
+    chunk->stage       = CHUNK_STAGE_EMPTY;
+    chunk->busy        = 0;
+    chunk->position    = position;
+    chunk->world_index = 0;
+    chunk->has_mesh    = 0;
+    chunk->dirty       = 1;
+    chunk->meshing     = 0;
+    chunk->queued      = 0;
+
+    chunk->stage_failures = 0;
+    chunk->stage_retry    = 0;
+
+    memset(&chunk->geometry, 0, sizeof(chunk->geometry));
+
+    chunk->occlusion_query   = 0;
+    chunk->occlusion_pending = 0;
+    chunk->occluded          = 0;
     return chunk;
 }
 
@@ -93,7 +104,9 @@ block_id_t chunk_get_block(chunk_t *chunk, ivec3s position) {
         return BLOCK_ID_AIR;
     }
 
-    return chunk->blocks[position.x + position.y * CHUNK_SIZE + position.z * (CHUNK_SIZE * CHUNK_HEIGHT)];
+    chunk_section_t *section = &chunk->sections[position.y / CHUNK_SECTION_HEIGHT];
+    size_t index             = CHUNK_SECTION_INDEX(position.x, position.y % CHUNK_SECTION_HEIGHT, position.z);
+    return block_storage_get(&section->blocks, index);
 }
 
 void chunk_set_block(chunk_t *chunk, ivec3s position, block_id_t block) {
@@ -107,68 +120,280 @@ void chunk_set_block(chunk_t *chunk, ivec3s position, block_id_t block) {
         return;
     }
 
-    chunk->blocks[position.x + position.y * CHUNK_SIZE + position.z * (CHUNK_SIZE * CHUNK_HEIGHT)] = block;
-    chunk->dirty                                                                                   = 1;
+    chunk_section_t *section = &chunk->sections[position.y / CHUNK_SECTION_HEIGHT];
+    size_t index             = CHUNK_SECTION_INDEX(position.x, position.y % CHUNK_SECTION_HEIGHT, position.z);
+
+    block_id_t previous = block_storage_get(&section->blocks, index);
+    if (previous == block) {
+        return;
+    }
+
+    block_storage_set(&section->blocks, index, block);
+
+    section->opaque_count += block_is_opaque(block) - block_is_opaque(previous);
+    section->empty = section->opaque_count == 0;
+    section->full  = section->opaque_count == CHUNK_SECTION_VOLUME;
+    section->dirty = 1;
+    chunk->dirty   = 1;
+
+    // Faces across the section border belong to the neighboring section
+    int y = position.y % CHUNK_SECTION_HEIGHT;
+    if (y == 0 && position.y > 0) {
+        chunk->sections[position.y / CHUNK_SECTION_HEIGHT - 1].dirty = 1;
+    } else if (y == CHUNK_SECTION_HEIGHT - 1 && position.y < CHUNK_HEIGHT - 1) {
+        chunk->sections[position.y / CHUNK_SECTION_HEIGHT + 1].dirty = 1;
+    }
 }
 
-void chunk_generate_mesh(chunk_t *chunk, shader_program_t *shader_program, tilemap_t *tilemap, chunk_t **neighbors) {
+int chunk_set_section_blocks(chunk_t *chunk, int section, const block_id_t *blocks) {
     if (chunk == NULL) {
-        LOG_ERROR("'chunk_generate_mesh' called with NULL chunk");
-        return;
+        LOG_ERROR("'chunk_set_section_blocks' called with NULL chunk");
+        return -1;
     }
 
-    if (shader_program == NULL) {
-        LOG_ERROR("'chunk_generate_mesh' called with NULL shader program");
-        return;
+    if (blocks == NULL) {
+        LOG_ERROR("'chunk_set_section_blocks' called with NULL blocks");
+        return -1;
     }
 
-    vertex_t *vertices  = (vertex_t *)malloc(CHUNK_VOLUME * 36 * sizeof(vertex_t));
-    uint32_t *indices   = (uint32_t *)malloc(CHUNK_VOLUME * 36 * sizeof(uint32_t));
-    size_t vertex_count = 0;
-    size_t index_count  = 0;
+    chunk_section_t *data = &chunk->sections[section];
+    if (block_storage_pack(&data->blocks, blocks) != 0) {
+        return -1;
+    }
+
+    int opaque_count = 0;
+    for (int i = 0; i < CHUNK_SECTION_VOLUME; ++i) {
+        opaque_count += block_is_opaque(blocks[i]);
+    }
+
+    data->opaque_count = opaque_count;
+    data->empty        = opaque_count == 0;
+    data->full         = opaque_count == CHUNK_SECTION_VOLUME;
+    data->dirty        = 1;
+    chunk->dirty       = 1;
+
+    // Faces across the section borders belong to the neighboring sections
+    if (section > 0) {
+        chunk->sections[section - 1].dirty = 1;
+    }
+    if (section < CHUNK_SECTION_COUNT - 1) {
+        chunk->sections[section + 1].dirty = 1;
+    }
+    return 0;
+}
+
+static void chunk_copy_free(chunk_t *copy) {
+    for (int s = 0; s < CHUNK_SECTION_COUNT; ++s) {
+        block_storage_free(&copy->sections[s].blocks);
+    }
+}
+
+static int chunk_copy(chunk_t *copy, const chunk_t *chunk) {
+    *copy                 = *chunk;
+    memset(&copy->geometry, 0, sizeof(copy->geometry));
+    copy->occlusion_query = 0;
+    copy->meshing         = 0;
+    copy->queued          = 0;
+    copy->busy            = 0;
+    for (int i = 0; i < 4; ++i) {
+        copy->neighbors[i] = NULL;
+    }
+
+    for (int s = 0; s < CHUNK_SECTION_COUNT; ++s) {
+        if (block_storage_copy(&copy->sections[s].blocks, &chunk->sections[s].blocks) != 0) {
+            while (s-- > 0) {
+                block_storage_free(&copy->sections[s].blocks);
+            }
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int chunk_snapshot_create(chunk_snapshot_t *snapshot, chunk_t *chunk, chunk_t **neighbors) {
+    if (snapshot == NULL) {
+        LOG_ERROR("'chunk_snapshot_create' called with NULL snapshot");
+        return -1;
+    }
+
+    if (chunk == NULL) {
+        LOG_ERROR("'chunk_snapshot_create' called with NULL chunk");
+        return -1;
+    }
 
-    block_faces_t faces = {0};
-    for (size_t i = 0; i < CHUNK_VOLUME; ++i) {
-        // Don't render transparent blocks
-        if (!block_is_opaque(chunk->blocks[i])) {
+    if (chunk_copy(&snapshot->chunk, chunk) != 0) {
+        return -1;
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        snapshot->neighbor_pointers[i] = NULL;
+        if (neighbors[i] == NULL) {
             continue;
         }
 
-        int x = i % CHUNK_SIZE;
-        int y = (i / CHUNK_SIZE) % CHUNK_HEIGHT;
-        int z = i / (CHUNK_SIZE * CHUNK_HEIGHT);
+        if (chunk_copy(&snapshot->neighbors[i], neighbors[i]) != 0) {
+            chunk_snapshot_free(snapshot);
+            return -1;
+        }
+        snapshot->neighbor_pointers[i] = &snapshot->neighbors[i];
+    }
+
+    return 0;
+}
+
+void chunk_snapshot_free(chunk_snapshot_t *snapshot) {
+    if (snapshot == NULL) {
+        LOG_ERROR("'chunk_snapshot_free' called with NULL snapshot");
+        return;
+    }
+
+    chunk_copy_free(&snapshot->chunk);
+    for (int i = 0; i < 4; ++i) {
+        if (snapshot->neighbor_pointers[i]) {
+            chunk_copy_free(snapshot->neighbor_pointers[i]);
+            snapshot->neighbor_pointers[i] = NULL;
+        }
+    }
+}
+
+int chunk_build_mesh(chunk_t *chunk, chunk_t **neighbors, chunk_mesh_mode_t mode, arena_t *scratch,
+                     chunk_mesh_data_t *data) {
+    if (chunk == NULL) {
+        LOG_ERROR("'chunk_build_mesh' called with NULL chunk");
+        return -1;
+    }
+
+    if (scratch == NULL) {
+        LOG_ERROR("'chunk_build_mesh' called with NULL scratch");
+        return -1;
+    }
+
+    if (data == NULL) {
+        LOG_ERROR("'chunk_build_mesh' called with NULL data");
+        return -1;
+    }
+
+    data->vertices = arena_alloc(scratch, CHUNK_MESH_SCRATCH_SIZE - ARENA_ALIGNMENT);
+    if (data->vertices == NULL) {
+        return -1;
+    }
+
+    data->vertex_count = 0;
+    for (int s = 0; s < CHUNK_SECTION_COUNT; ++s) {
+        size_t capacity = 0;
+        data->section_vertex_counts[s] =
+            build_section_slot(chunk, s, neighbors, mode, &data->vertices[data->vertex_count], &capacity);
+        data->section_vertex_capacities[s] = capacity;
+        data->section_visibilities[s]      = chunk_visibility_build_section(chunk, s);
+        data->vertex_count += capacity;
+    }
+
+    return 0;
+}
+
+int chunk_upload_mesh(chunk_t *chunk, const chunk_mesh_data_t *data, vertex_pool_t *pool, staging_ring_t *staging) {
+    if (chunk == NULL) {
+        LOG_ERROR("'chunk_upload_mesh' called with NULL chunk");
+        return -1;
+    }
+
+    if (data == NULL) {
+        LOG_ERROR("'chunk_upload_mesh' called with NULL data");
+        return -1;
+    }
 
-        block_id_t block = chunk->blocks[i];
-        block_get_faces(block, (vec3s) {{x, y, z}}, tilemap, &faces);
+    if (pool == NULL) {
+        LOG_ERROR("'chunk_upload_mesh' called with NULL pool");
+        return -1;
+    }
+
+    // Keep the current range while the vertices fit and use at least half of it, so remeshing rarely moves a chunk
+    vertex_pool_allocation_t *geometry = &chunk->geometry;
+    if (geometry->pool && (data->vertex_count > geometry->count || data->vertex_count < geometry->count / 2)) {
+        vertex_pool_free(geometry);
+    }
 
-        for (int j = 0; j < 6; ++j) {
-            if (!should_render_face(chunk, j, (ivec3s) {{x, y, z}}, neighbors)) {
-                continue;
+    if (data->vertex_count > 0) {
+        // Chunk meshes are plain quads, the index pattern comes from the shared quad index buffer
+        if (geometry->pool == NULL) {
+            if (vertex_pool_alloc(pool, geometry, data->vertex_count) != 0) {
+                chunk->has_mesh = 0;
+                return -1;
             }
 
-            memcpy(&vertices[vertex_count], faces.values[j].vertices, 4 * sizeof(vertex_t));
-            vertex_count += 4;
+            vec3s origin = {{chunk->position.x * CHUNK_SIZE, 0.0f, chunk->position.y * CHUNK_SIZE}};
+            vertex_pool_set_origin(geometry, origin);
+        }
+
+        if (mesh_quad_indices_reserve(data->vertex_count / 4) == 0) {
+            vertex_pool_free(geometry);
+            chunk->has_mesh = 0;
+            return -1;
+        }
 
-            indices[index_count++] = vertex_count - 4;
-            indices[index_count++] = vertex_count - 3;
-            indices[index_count++] = vertex_count - 2;
-            indices[index_count++] = vertex_count - 2;
-            indices[index_count++] = vertex_count - 1;
-            indices[index_count++] = vertex_count - 4;
+        size_t count = data->vertex_count;
+        if (staging == NULL) {
+            vertex_pool_upload(geometry, 0, data->vertices, count);
+        } else if (vertex_pool_upload_staged(geometry, 0, data->vertices, count, staging) != 0) {
+            // Callers check the room left in the ring, so this is a failed mapping rather than a full ring
+            LOG_WARN("Failed to stage the vertices of chunk (%d, %d), uploading them directly", chunk->position.x,
+                     chunk->position.y);
+            vertex_pool_upload(geometry, 0, data->vertices, count);
         }
     }
 
-    vertices = (vertex_t *)realloc(vertices, vertex_count * sizeof(vertex_t));
-    indices  = (uint32_t *)realloc(indices, index_count * sizeof(uint32_t));
+    size_t vertex_offset = 0;
+    for (int s = 0; s < CHUNK_SECTION_COUNT; ++s) {
+        chunk_section_t *section = &chunk->sections[s];
+        section->vertex_offset   = vertex_offset;
+        section->vertex_count    = data->section_vertex_counts[s];
+        section->vertex_capacity = data->section_vertex_capacities[s];
+        section->index_offset    = vertex_offset / 4 * 6;
+        section->index_count     = section->vertex_count / 4 * 6;
+        section->visibility      = data->section_visibilities[s];
+        vertex_offset += section->vertex_capacity;
+    }
 
-    mesh_set_vertices(chunk->mesh, vertices, vertex_count);
-    mesh_set_indices(chunk->mesh, indices, index_count);
-    free(vertices);
-    free(indices);
+    chunk->has_mesh = 1;
+    return 0;
+}
 
-    chunk->mesh->texture        = tilemap->texture;
-    chunk->mesh->shader_program = shader_program;
-    chunk->dirty                = 0;
+int chunk_update_section_mesh(chunk_t *chunk, int section, chunk_t **neighbors, chunk_mesh_mode_t mode,
+                              arena_t *scratch) {
+    if (chunk == NULL) {
+        LOG_ERROR("'chunk_update_section_mesh' called with NULL chunk");
+        return -1;
+    }
+
+    if (scratch == NULL) {
+        LOG_ERROR("'chunk_update_section_mesh' called with NULL scratch");
+        return -1;
+    }
+
+    if (!chunk->has_mesh || chunk->geometry.pool == NULL) {
+        return -1;
+    }
+
+    chunk_vertex_t *vertices = arena_alloc(scratch, CHUNK_SECTION_SCRATCH_SIZE - ARENA_ALIGNMENT);
+    if (vertices == NULL) {
+        return -1;
+    }
+
+    chunk_section_t *data = &chunk->sections[section];
+    size_t vertex_count   = build_section_slot(chunk, section, neighbors, mode, vertices, &data->vertex_capacity);
+    if (vertex_count > data->vertex_capacity) {
+        return -1;
+    }
+
+    // Patch the whole slot so the quads the section lost turn degenerate
+    vertex_pool_upload(&chunk->geometry, data->vertex_offset, vertices, data->vertex_capacity);
+
+    data->vertex_count = vertex_count;
+    data->index_count  = vertex_count / 4 * 6;
+    data->visibility   = chunk_visibility_build_section(chunk, section);
+    data->dirty        = 0;
+    return 0;
 }
 
 void chunk_destroy(chunk_t *chunk) {
@@ -177,7 +402,14 @@ void chunk_destroy(chunk_t *chunk) {
         return;
     }
 
-    mesh_destroy(chunk->mesh);
-    free(chunk->blocks);
+    if (chunk->geometry.pool) {
+        vertex_pool_free(&chunk->geometry);
+    }
+    if (chunk->occlusion_query) {
+        occlusion_query_destroy(&chunk->occlusion_query);
+    }
+    for (int i = 0; i < CHUNK_SECTION_COUNT; ++i) {
+        block_storage_free(&chunk->sections[i].blocks);
+    }
     free(chunk);
 }
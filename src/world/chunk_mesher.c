@@ -0,0 +1,227 @@
+#include "world/chunk_mesher.h"
+
+#include <string.h>
+
+#include "core/log.h"
+
+// Columns carry one bit per block of the section, shifted up by one so bit 0 and bit CHUNK_SECTION_HEIGHT + 1 can
+// hold the blocks right below and above the section.
+#define COLUMN_BLOCKS_MASK (((1u << CHUNK_SECTION_HEIGHT) - 1) << 1)
+
+typedef struct {
+    // Unpacked section blocks, indexed by CHUNK_SECTION_INDEX
+    block_id_t blocks[CHUNK_SECTION_VOLUME];
+
+    // Opacity of every column of the section plus a one column halo from the neighbor chunks, indexed [z + 1][x + 1]
+    uint32_t columns[CHUNK_SIZE + 2][CHUNK_SIZE + 2];
+
+    // Visible faces of every column, indexed [face][z][x], one bit per block using the column bit layout
+    uint32_t faces[6][CHUNK_SIZE][CHUNK_SIZE];
+} section_masks_t;
+
+static int lowest_bit(uint32_t bits) { return __builtin_ctz(bits); }
+
+static uint32_t section_column(chunk_t *chunk, int section, int x, int z) {
+    chunk_section_t *data = &chunk->sections[section];
+    if (data->empty) {
+        return 0;
+    }
+
+    if (data->full) {
+        return COLUMN_BLOCKS_MASK;
+    }
+
+    uint32_t column = 0;
+    for (int y = 0; y < CHUNK_SECTION_HEIGHT; ++y) {
+        ivec3s position = (ivec3s) {{x, y + section * CHUNK_SECTION_HEIGHT, z}};
+        column |= (uint32_t)block_is_opaque(chunk_get_block(chunk, position)) << (y + 1);
+    }
+    return column;
+}
+
+static void build_masks(chunk_t *chunk, int section, chunk_t **neighbors, section_masks_t *masks) {
+    block_storage_unpack(&chunk->sections[section].blocks, masks->blocks);
+
+    memset(masks->columns, 0, sizeof(masks->columns));
+
+    // Section columns, with the halo bits from the sections below and above. Blocks outside of the chunk count as
+    // transparent.
+    int bottom = section * CHUNK_SECTION_HEIGHT - 1;
+    int top    = (section + 1) * CHUNK_SECTION_HEIGHT;
+    for (int z = 0; z < CHUNK_SIZE; ++z) {
+        for (int x = 0; x < CHUNK_SIZE; ++x) {
+            uint32_t column = 0;
+            for (int y = 0; y < CHUNK_SECTION_HEIGHT; ++y) {
+                column |= (uint32_t)block_is_opaque(masks->blocks[CHUNK_SECTION_INDEX(x, y, z)]) << (y + 1);
+            }
+
+            column |= (uint32_t)block_is_opaque(chunk_get_block(chunk, (ivec3s) {{x, bottom, z}}));
+            column |= (uint32_t)block_is_opaque(chunk_get_block(chunk, (ivec3s) {{x, top, z}}))
+                      << (CHUNK_SECTION_HEIGHT + 1);
+
+            masks->columns[z + 1][x + 1] = column;
+        }
+    }
+
+    // Halo columns from the neighbor chunks, missing neighbors count as transparent
+    for (int i = 0; i < CHUNK_SIZE; ++i) {
+        if (neighbors[CHUNK_NEIGHBOR_FRONT]) {
+            masks->columns[CHUNK_SIZE + 1][i + 1] = section_column(neighbors[CHUNK_NEIGHBOR_FRONT], section, i, 0);
+        }
+        if (neighbors[CHUNK_NEIGHBOR_BACK]) {
+            masks->columns[0][i + 1] = section_column(neighbors[CHUNK_NEIGHBOR_BACK], section, i, CHUNK_SIZE - 1);
+        }
+        if (neighbors[CHUNK_NEIGHBOR_LEFT]) {
+            masks->columns[i + 1][0] = section_column(neighbors[CHUNK_NEIGHBOR_LEFT], section, CHUNK_SIZE - 1, i);
+        }
+        if (neighbors[CHUNK_NEIGHBOR_RIGHT]) {
+            masks->columns[i + 1][CHUNK_SIZE + 1] = section_column(neighbors[CHUNK_NEIGHBOR_RIGHT], section, 0, i);
+        }
+    }
+
+    // A face is visible where an opaque block meets a transparent one
+    for (int z = 0; z < CHUNK_SIZE; ++z) {
+        for (int x = 0; x < CHUNK_SIZE; ++x) {
+            uint32_t column = masks->columns[z + 1][x + 1];
+            uint32_t opaque = column & COLUMN_BLOCKS_MASK;
+
+            masks->faces[BLOCK_FACE_TOP][z][x]    = opaque & ~(column >> 1);
+            masks->faces[BLOCK_FACE_BOTTOM][z][x] = opaque & ~(column << 1);
+            masks->faces[BLOCK_FACE_FRONT][z][x]  = opaque & ~masks->columns[z + 2][x + 1];
+            masks->faces[BLOCK_FACE_BACK][z][x]   = opaque & ~masks->columns[z][x + 1];
+            masks->faces[BLOCK_FACE_LEFT][z][x]   = opaque & ~masks->columns[z + 1][x];
+            masks->faces[BLOCK_FACE_RIGHT][z][x]  = opaque & ~masks->columns[z + 1][x + 2];
+        }
+    }
+}
+
+static size_t build_naive(section_masks_t *masks, int section, chunk_vertex_t *vertices) {
+    size_t vertex_count = 0;
+
+    for (int face = 0; face < 6; ++face) {
+        for (int z = 0; z < CHUNK_SIZE; ++z) {
+            for (int x = 0; x < CHUNK_SIZE; ++x) {
+                for (uint32_t bits = masks->faces[face][z][x]; bits; bits &= bits - 1) {
+                    int y            = lowest_bit(bits) - 1;
+                    block_id_t block = masks->blocks[CHUNK_SECTION_INDEX(x, y, z)];
+
+                    // Copy the face template and move it into place
+                    const block_face_data_t *quad = block_get_face_template(block, face);
+                    uint32_t offset = CHUNK_VERTEX_PACK_POSITION(x, y + section * CHUNK_SECTION_HEIGHT, z);
+                    for (int i = 0; i < 4; ++i) {
+                        vertices[vertex_count + i].position = quad->vertices[i].position + offset;
+                        vertices[vertex_count + i].texture  = quad->vertices[i].texture;
+                    }
+                    vertex_count += 4;
+                }
+            }
+        }
+    }
+
+    return vertex_count;
+}
+
+static size_t build_greedy(section_masks_t *masks, int section, chunk_vertex_t *vertices) {
+    size_t vertex_count = 0;
+
+    // Every face slice of a section is CHUNK_SIZE x CHUNK_SIZE, indexed by the face's v and u coordinates
+    tile_id_t tiles[CHUNK_SIZE][CHUNK_SIZE];
+    block_id_t blocks[CHUNK_SIZE][CHUNK_SIZE];
+    block_face_data_t quad;
+
+    for (int face = 0; face < 6; ++face) {
+        int u_axis      = block_face_u_axis(face);
+        int v_axis      = block_face_v_axis(face);
+        int normal_axis = 3 - u_axis - v_axis;
+
+        for (int layer = 0; layer < CHUNK_SIZE; ++layer) {
+            // Gather the visible faces of the slice
+            for (int v = 0; v < CHUNK_SIZE; ++v) {
+                for (int u = 0; u < CHUNK_SIZE; ++u) {
+                    ivec3s position           = GLMS_IVEC3_ZERO_INIT;
+                    position.raw[normal_axis] = layer;
+                    position.raw[u_axis]      = u;
+                    position.raw[v_axis]      = v;
+
+                    if (masks->faces[face][position.z][position.x] & (1u << (position.y + 1))) {
+                        block_id_t block = masks->blocks[CHUNK_SECTION_INDEX(position.x, position.y, position.z)];
+                        tiles[v][u]      = block_get_tile(block, face);
+                        blocks[v][u]     = block;
+                    } else {
+                        tiles[v][u] = TILE_ID_NONE;
+                    }
+                }
+            }
+
+            // Merge runs of equal tiles along u, then grow them along v as long as the whole run matches
+            for (int v = 0; v < CHUNK_SIZE; ++v) {
+                for (int u = 0; u < CHUNK_SIZE;) {
+                    tile_id_t tile = tiles[v][u];
+                    if (tile == TILE_ID_NONE) {
+                        ++u;
+                        continue;
+                    }
+
+                    int width = 1;
+                    while (u + width < CHUNK_SIZE && tiles[v][u + width] == tile) {
+                        ++width;
+                    }
+
+                    int height = 1;
+                    for (; v + height < CHUNK_SIZE; ++height) {
+                        int k = 0;
+                        while (k < width && tiles[v + height][u + k] == tile) {
+                            ++k;
+                        }
+                        if (k < width) {
+                            break;
+                        }
+                    }
+
+                    for (int dv = 0; dv < height; ++dv) {
+                        for (int du = 0; du < width; ++du) {
+                            tiles[v + dv][u + du] = TILE_ID_NONE;
+                        }
+                    }
+
+                    ivec3s position           = GLMS_IVEC3_ZERO_INIT;
+                    position.raw[normal_axis] = layer;
+                    position.raw[u_axis]      = u;
+                    position.raw[v_axis]      = v;
+                    position.y += section * CHUNK_SECTION_HEIGHT;
+
+                    block_get_face(blocks[v][u], face, position, (ivec2s) {{width, height}}, &quad);
+                    memcpy(&vertices[vertex_count], quad.vertices, sizeof(quad.vertices));
+                    vertex_count += 4;
+                    u += width;
+                }
+            }
+        }
+    }
+
+    return vertex_count;
+}
+
+size_t chunk_mesher_build_section(chunk_t *chunk, int section, chunk_t **neighbors, chunk_mesh_mode_t mode,
+                                  chunk_vertex_t *vertices) {
+    if (chunk == NULL) {
+        LOG_ERROR("'chunk_mesher_build_section' called with NULL chunk");
+        return 0;
+    }
+
+    if (vertices == NULL) {
+        LOG_ERROR("'chunk_mesher_build_section' called with NULL vertices");
+        return 0;
+    }
+
+    section_masks_t masks;
+    build_masks(chunk, section, neighbors, &masks);
+
+    switch (mode) {
+        case CHUNK_MESH_MODE_GREEDY:
+            return build_greedy(&masks, section, vertices);
+        case CHUNK_MESH_MODE_NAIVE:
+        default:
+            return build_naive(&masks, section, vertices);
+    }
+}
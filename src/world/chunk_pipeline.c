@@ -0,0 +1,194 @@
+#include "world/chunk_pipeline.h"
+
+#include <stdlib.h>
+
+#include "core/job_system.h"
+#include "core/log.h"
+#include "core/math.h"
+
+// Failed stages back off up to this power of two of updates between retries
+#define CHUNK_PIPELINE_MAX_BACKOFF 8
+
+typedef struct {
+    // Stage the job advances the chunk to
+    chunk_stage_t stage;
+
+    chunk_t *chunk;
+    chunk_pipeline_t *pipeline;
+
+    const terrain_t *terrain;
+    int failed;
+
+    job_counter_t *counter;
+} stage_job_t;
+
+struct chunk_pipeline {
+    int max_jobs;
+
+    // Calls to `chunk_pipeline_update` so far, failed stages are retried after a number of them
+    uint32_t updates;
+
+    // Stage jobs in flight, including the main thread continuations not run yet
+    job_counter_t jobs;
+};
+
+// Locks the chunk. Atomic, since a worker unlocks it itself when its continuation cannot be queued.
+static void lock_chunk(stage_job_t *job, int delta) { __atomic_add_fetch(&job->chunk->busy, delta, __ATOMIC_ACQ_REL); }
+
+// Runs on the main thread once the worker side of the stage is done
+static void stage_job_finish(void *arg, int worker) {
+    stage_job_t *job = arg;
+    chunk_t *chunk   = job->chunk;
+    (void)worker;
+
+    lock_chunk(job, -1);
+    if (job->failed) {
+        // Retried after twice as many updates as the last time, so a chunk that keeps failing does not flood the log
+        int shift = MIN(chunk->stage_failures, CHUNK_PIPELINE_MAX_BACKOFF);
+        ++chunk->stage_failures;
+        chunk->stage_retry = job->pipeline->updates + (1u << shift);
+        LOG_WARN("Chunk (%d, %d) failed to reach stage %d, retrying in %u updates", chunk->position.x,
+                 chunk->position.y, job->stage, 1u << shift);
+    } else {
+        chunk->stage          = job->stage;
+        chunk->stage_failures = 0;
+    }
+
+    free(job);
+}
+
+static void stage_job_run(void *arg, int worker) {
+    stage_job_t *job = arg;
+    (void)worker;
+
+    switch (job->stage) {
+        case CHUNK_STAGE_GENERATED:
+            job->failed = terrain_generate_chunk(job->terrain, job->chunk) != 0;
+            break;
+        case CHUNK_STAGE_DECORATED:
+            job->failed = terrain_decorate_chunk(job->terrain, job->chunk) != 0;
+            break;
+        default:
+            job->failed = 1;
+            break;
+    }
+
+    // The chunk stays busy until the continuation runs. Without one the stage is dropped and the chunk unlocked here,
+    // it keeps its stage and is scheduled again.
+    job_t finish = {stage_job_finish, job, JOB_PRIORITY_NORMAL, job->counter};
+    if (job_system_submit_main_thread(&finish) != 0) {
+        LOG_ERROR("Failed to queue the completion of chunk (%d, %d)", job->chunk->position.x, job->chunk->position.y);
+        lock_chunk(job, -1);
+        free(job);
+    }
+}
+
+// Checks if every neighbor exists and reached the stage
+static int neighbors_ready(chunk_t *chunk, chunk_stage_t stage) {
+    for (int i = 0; i < 4; ++i) {
+        chunk_t *neighbor = chunk->neighbors[i];
+        if (neighbor == NULL || neighbor->stage < stage) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int submit_stage_job(chunk_pipeline_t *pipeline, world_t *world, chunk_t *chunk, chunk_stage_t stage) {
+    stage_job_t *job = calloc(1, sizeof(stage_job_t));
+    if (job == NULL) {
+        LOG_ERROR("Failed to allocate chunk stage job");
+        return -1;
+    }
+
+    job->stage    = stage;
+    job->chunk    = chunk;
+    job->pipeline = pipeline;
+    job->terrain  = &world->terrain;
+    job->counter  = &pipeline->jobs;
+
+    // Generation is the bulk of the work and feeds chunks furthest from being drawn, let the later stages and meshing
+    // overtake it
+    job_priority_t priority = stage == CHUNK_STAGE_GENERATED ? JOB_PRIORITY_LOW : JOB_PRIORITY_NORMAL;
+
+    lock_chunk(job, 1);
+    job_t run = {stage_job_run, job, priority, job->counter};
+    if (job_system_submit(&run) != 0) {
+        lock_chunk(job, -1);
+        free(job);
+        return -1;
+    }
+
+    return 0;
+}
+
+// Schedules the next stage of the chunk if its neighbors allow it
+static int advance_chunk(chunk_pipeline_t *pipeline, world_t *world, chunk_t *chunk) {
+    // Wraparound safe, a failed stage waits until its retry update comes
+    if (chunk_is_busy(chunk) || (chunk->stage_failures > 0 && (int32_t)(pipeline->updates - chunk->stage_retry) < 0)) {
+        return 0;
+    }
+
+    switch (chunk->stage) {
+        case CHUNK_STAGE_EMPTY:
+            return submit_stage_job(pipeline, world, chunk, CHUNK_STAGE_GENERATED) == 0;
+        case CHUNK_STAGE_GENERATED:
+            // Decoration only writes the chunk's own blocks, it does not wait for the neighbors
+            return submit_stage_job(pipeline, world, chunk, CHUNK_STAGE_DECORATED) == 0;
+        case CHUNK_STAGE_DECORATED:
+            // Meshing reads the border blocks of the neighbors, which are final once they are decorated
+            if (neighbors_ready(chunk, CHUNK_STAGE_DECORATED)) {
+                chunk->stage = CHUNK_STAGE_MESHED;
+                chunk->dirty = 1;
+                world_queue_dirty_chunk(world, chunk);
+            }
+            break;
+        default:
+            break;
+    }
+    return 0;
+}
+
+chunk_pipeline_t *chunk_pipeline_create(int max_jobs) {
+    chunk_pipeline_t *pipeline = calloc(1, sizeof(chunk_pipeline_t));
+    if (pipeline == NULL) {
+        LOG_ERROR("Failed to allocate chunk pipeline");
+        return NULL;
+    }
+
+    pipeline->max_jobs = max_jobs > 0 ? max_jobs : 1;
+    return pipeline;
+}
+
+void chunk_pipeline_destroy(chunk_pipeline_t *pipeline) {
+    if (pipeline == NULL) {
+        LOG_ERROR("'chunk_pipeline_destroy' called with NULL pipeline");
+        return;
+    }
+
+    // Lets every job in flight land, their chunks must still be alive
+    job_system_wait(&pipeline->jobs);
+    free(pipeline);
+}
+
+int chunk_pipeline_update(chunk_pipeline_t *pipeline, world_t *world) {
+    if (pipeline == NULL) {
+        LOG_ERROR("'chunk_pipeline_update' called with NULL pipeline");
+        return 0;
+    }
+
+    if (world == NULL) {
+        LOG_ERROR("'chunk_pipeline_update' called with NULL world");
+        return 0;
+    }
+
+    ++pipeline->updates;
+
+    // Chunks are visited in load order, which streaming keeps roughly nearest first
+    int scheduled = 0;
+    for (size_t i = 0; i < world->chunk_count && job_counter_get(&pipeline->jobs) < pipeline->max_jobs; ++i) {
+        scheduled += advance_chunk(pipeline, world, world->chunks[i]);
+    }
+
+    return scheduled;
+}
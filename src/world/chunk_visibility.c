@@ -0,0 +1,87 @@
+#include "world/chunk_visibility.h"
+
+// Faces of the section border the block at the given position lies on
+static uint32_t border_faces(int x, int y, int z) {
+    uint32_t faces = 0;
+    faces |= (uint32_t)(x == 0) << CHUNK_FACE_LEFT;
+    faces |= (uint32_t)(x == CHUNK_SIZE - 1) << CHUNK_FACE_RIGHT;
+    faces |= (uint32_t)(z == 0) << CHUNK_FACE_BACK;
+    faces |= (uint32_t)(z == CHUNK_SIZE - 1) << CHUNK_FACE_FRONT;
+    faces |= (uint32_t)(y == 0) << CHUNK_FACE_BOTTOM;
+    faces |= (uint32_t)(y == CHUNK_SECTION_HEIGHT - 1) << CHUNK_FACE_TOP;
+    return faces;
+}
+
+static uint32_t connect_faces(uint32_t faces) {
+    uint32_t visibility = 0;
+    for (int a = 0; a < CHUNK_FACE_COUNT; ++a) {
+        for (int b = a + 1; b < CHUNK_FACE_COUNT; ++b) {
+            if ((faces >> a & 1) && (faces >> b & 1)) {
+                visibility |= CHUNK_VISIBILITY_BIT(a, b);
+            }
+        }
+    }
+    return visibility;
+}
+
+uint32_t chunk_visibility_build_section(chunk_t *chunk, int section) {
+    chunk_section_t *data = &chunk->sections[section];
+    if (data->empty) {
+        return CHUNK_VISIBILITY_ALL;
+    }
+
+    if (data->full) {
+        return 0;
+    }
+
+    block_id_t blocks[CHUNK_SECTION_VOLUME];
+    block_storage_unpack(&data->blocks, blocks);
+
+    // Opaque blocks start out visited, so the flood fills below only walk through open space
+    uint8_t visited[CHUNK_SECTION_VOLUME];
+    for (int i = 0; i < CHUNK_SECTION_VOLUME; ++i) {
+        visited[i] = block_is_opaque(blocks[i]);
+    }
+
+    uint16_t queue[CHUNK_SECTION_VOLUME];
+    uint32_t visibility = 0;
+    for (int start = 0; start < CHUNK_SECTION_VOLUME && visibility != CHUNK_VISIBILITY_ALL; ++start) {
+        if (visited[start]) {
+            continue;
+        }
+
+        // Every block enters the queue once, so it never holds more than the section's volume
+        uint32_t faces = 0;
+        int head       = 0;
+        int tail       = 0;
+        queue[tail++]  = start;
+        visited[start] = 1;
+        while (head < tail) {
+            int index = queue[head++];
+            int x     = index % CHUNK_SIZE;
+            int z     = index / CHUNK_SIZE % CHUNK_SIZE;
+            int y     = index / (CHUNK_SIZE * CHUNK_SIZE);
+
+            faces |= border_faces(x, y, z);
+
+            int neighbors[6] = {
+                x > 0 ? index - 1 : -1,
+                x < CHUNK_SIZE - 1 ? index + 1 : -1,
+                z > 0 ? index - CHUNK_SIZE : -1,
+                z < CHUNK_SIZE - 1 ? index + CHUNK_SIZE : -1,
+                y > 0 ? index - CHUNK_SIZE * CHUNK_SIZE : -1,
+                y < CHUNK_SECTION_HEIGHT - 1 ? index + CHUNK_SIZE * CHUNK_SIZE : -1,
+            };
+            for (int n = 0; n < 6; ++n) {
+                if (neighbors[n] >= 0 && !visited[neighbors[n]]) {
+                    visited[neighbors[n]] = 1;
+                    queue[tail++]         = neighbors[n];
+                }
+            }
+        }
+
+        visibility |= connect_faces(faces);
+    }
+
+    return visibility;
+}
@@ -0,0 +1,221 @@
+#include "world/terrain.h"
+
+#include "core/log.h"
+#include "core/math.h"
+
+// Layers of dirt below the grass
+#define DIRT_DEPTH 3
+
+// Caves never reach the bottom layers and stay this many blocks below the surface so they do not break through
+#define CAVE_MIN_HEIGHT    4
+#define CAVE_SURFACE_DEPTH 6
+
+// Boulders are cobblestone balls resting on the surface, centered anywhere in the chunk along one axis so they spill
+// into the neighbor on that side
+#define BOULDER_MAX_COUNT  2
+#define BOULDER_MIN_RADIUS 1
+#define BOULDER_MAX_RADIUS 2
+
+// Per chunk random numbers for decorations, independent of the order chunks are decorated in
+static uint32_t decoration_hash(uint32_t seed, ivec2s position, uint32_t index) {
+    uint32_t h = seed ^ ((uint32_t)position.x * 0x27D4EB2Du) ^ ((uint32_t)position.y * 0x165667B1u);
+    h ^= index * 0x9E3779B1u;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    h *= 0x297A2D39u;
+    h ^= h >> 15;
+    return h;
+}
+
+// Surface height of every column of the chunk at the given position, indexed by `x + z * CHUNK_SIZE`. Shared by
+// generation and decoration, so decorations rest on the generated surface whatever the chunk holds by then.
+static void column_heights(const terrain_t *terrain, ivec2s position, int *heights) {
+    float surface[CHUNK_SIZE * CHUNK_SIZE];
+    noise_fbm_2d_plane(&terrain->height, (float)(position.x * CHUNK_SIZE), (float)(position.y * CHUNK_SIZE), surface);
+
+    for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; ++i) {
+        int height = terrain->base_height + (int)floorf(surface[i] * terrain->height_amplitude);
+        heights[i] = CLAMP(height, 1, CHUNK_HEIGHT - 1);
+    }
+}
+
+void terrain_init(terrain_t *terrain, uint32_t seed) {
+    if (terrain == NULL) {
+        LOG_ERROR("'terrain_init' called with NULL terrain");
+        return;
+    }
+
+    terrain->height.seed       = seed;
+    terrain->height.octaves    = 5;
+    terrain->height.frequency  = 1.0f / 128.0f;
+    terrain->height.lacunarity = 2.0f;
+    terrain->height.gain       = 0.5f;
+
+    terrain->caves.seed       = seed ^ 0x5BD1E995u;
+    terrain->caves.octaves    = 2;
+    terrain->caves.frequency  = 1.0f / 32.0f;
+    terrain->caves.lacunarity = 2.0f;
+    terrain->caves.gain       = 0.5f;
+
+    terrain->base_height      = 64;
+    terrain->height_amplitude = 48;
+    terrain->cave_threshold   = 0.2f;
+}
+
+static block_id_t surface_block(int y, int height) {
+    if (y > height) {
+        return BLOCK_ID_AIR;
+    }
+    if (y == height) {
+        return BLOCK_ID_GRASS;
+    }
+    if (y >= height - DIRT_DEPTH) {
+        return BLOCK_ID_DIRT;
+    }
+    return BLOCK_ID_STONE;
+}
+
+int terrain_generate_chunk(const terrain_t *terrain, chunk_t *chunk) {
+    if (terrain == NULL) {
+        LOG_ERROR("'terrain_generate_chunk' called with NULL terrain");
+        return -1;
+    }
+
+    if (chunk == NULL) {
+        LOG_ERROR("'terrain_generate_chunk' called with NULL chunk");
+        return -1;
+    }
+
+    float origin_x = (float)(chunk->position.x * CHUNK_SIZE);
+    float origin_z = (float)(chunk->position.y * CHUNK_SIZE);
+
+    int heights[CHUNK_SIZE * CHUNK_SIZE];
+    column_heights(terrain, chunk->position, heights);
+
+    int max_height = 0;
+    for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; ++i) {
+        max_height = MAX(max_height, heights[i]);
+    }
+
+    float caves[CHUNK_SECTION_VOLUME];
+    block_id_t blocks[CHUNK_SECTION_VOLUME];
+
+    // Sections above the highest column stay air
+    for (int s = 0; s <= max_height / CHUNK_SECTION_HEIGHT; ++s) {
+        int section_y = s * CHUNK_SECTION_HEIGHT;
+
+        int has_caves = section_y + CHUNK_SECTION_HEIGHT > CAVE_MIN_HEIGHT &&
+                        section_y < max_height - CAVE_SURFACE_DEPTH;
+        if (has_caves) {
+            noise_fbm_3d_section(&terrain->caves, origin_x, (float)section_y, origin_z, caves);
+        }
+
+        for (int y = 0; y < CHUNK_SECTION_HEIGHT; ++y) {
+            int block_y = section_y + y;
+            for (int z = 0; z < CHUNK_SIZE; ++z) {
+                for (int x = 0; x < CHUNK_SIZE; ++x) {
+                    int height       = heights[x + z * CHUNK_SIZE];
+                    size_t index     = CHUNK_SECTION_INDEX(x, y, z);
+                    block_id_t block = surface_block(block_y, height);
+
+                    if (has_caves && block != BLOCK_ID_AIR && block_y >= CAVE_MIN_HEIGHT &&
+                        block_y < height - CAVE_SURFACE_DEPTH && caves[index] > terrain->cave_threshold) {
+                        block = BLOCK_ID_AIR;
+                    }
+                    blocks[index] = block;
+                }
+            }
+        }
+
+        if (chunk_set_section_blocks(chunk, s, blocks) != 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+// Places the parts of the boulders of the chunk at `source` that fall into `chunk`. The boulders only depend on the
+// seed and the generated surface of their chunk, so every chunk they touch places the same blocks.
+static void place_boulders(const terrain_t *terrain, chunk_t *chunk, ivec2s source) {
+    uint32_t seed  = terrain->height.seed ^ 0xB5297A4Du;
+    uint32_t count = decoration_hash(seed, source, 0) % (BOULDER_MAX_COUNT + 1);
+
+    // Offset of the source chunk's blocks in the decorated chunk
+    int offset_x = (source.x - chunk->position.x) * CHUNK_SIZE;
+    int offset_z = (source.y - chunk->position.y) * CHUNK_SIZE;
+
+    int heights[CHUNK_SIZE * CHUNK_SIZE];
+    int has_heights = 0;
+    for (uint32_t b = 0; b < count; ++b) {
+        uint32_t h = decoration_hash(seed, source, b + 1);
+        int radius = BOULDER_MIN_RADIUS + (int)(h % (BOULDER_MAX_RADIUS - BOULDER_MIN_RADIUS + 1));
+        int along  = (int)((h >> 8) % CHUNK_SIZE);
+        int inner  = radius + (int)((h >> 16) % (CHUNK_SIZE - 2 * radius));
+
+        // Only one axis may cross the border, so a boulder never reaches a diagonal neighbor
+        int center_x = (h >> 24) & 1 ? along : inner;
+        int center_z = (h >> 24) & 1 ? inner : along;
+
+        int min_x = MAX(offset_x + center_x - radius, 0);
+        int max_x = MIN(offset_x + center_x + radius, CHUNK_SIZE - 1);
+        int min_z = MAX(offset_z + center_z - radius, 0);
+        int max_z = MIN(offset_z + center_z + radius, CHUNK_SIZE - 1);
+        if (min_x > max_x || min_z > max_z) {
+            continue;
+        }
+
+        // Caves stay below the surface, so the boulder rests on the top block of its column
+        if (!has_heights) {
+            column_heights(terrain, source, heights);
+            has_heights = 1;
+        }
+        int center_y = heights[center_x + center_z * CHUNK_SIZE];
+
+        for (int y = MAX(center_y - radius, 0); y <= MIN(center_y + radius, CHUNK_HEIGHT - 1); ++y) {
+            for (int z = min_z; z <= max_z; ++z) {
+                for (int x = min_x; x <= max_x; ++x) {
+                    int dx = x - offset_x - center_x;
+                    int dy = y - center_y;
+                    int dz = z - offset_z - center_z;
+                    if (dx * dx + dy * dy + dz * dz > radius * radius) {
+                        continue;
+                    }
+
+                    ivec3s position = (ivec3s) {{x, y, z}};
+                    if (chunk_get_block(chunk, position) == BLOCK_ID_AIR) {
+                        chunk_set_block(chunk, position, BLOCK_ID_COBBLESTONE);
+                    }
+                }
+            }
+        }
+    }
+}
+
+int terrain_decorate_chunk(const terrain_t *terrain, chunk_t *chunk) {
+    if (terrain == NULL) {
+        LOG_ERROR("'terrain_decorate_chunk' called with NULL terrain");
+        return -1;
+    }
+
+    if (chunk == NULL) {
+        LOG_ERROR("'terrain_decorate_chunk' called with NULL chunk");
+        return -1;
+    }
+
+    // Boulders of the four neighbors may reach into the chunk, diagonal ones never do
+    ivec2s position   = chunk->position;
+    ivec2s sources[5] = {
+        position,
+        {{position.x - 1, position.y}},
+        {{position.x + 1, position.y}},
+        {{position.x, position.y - 1}},
+        {{position.x, position.y + 1}},
+    };
+    for (int i = 0; i < 5; ++i) {
+        place_boulders(terrain, chunk, sources[i]);
+    }
+
+    return 0;
+}
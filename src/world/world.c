@@ -4,32 +4,122 @@
 
 #include "core/log.h"
 
+#define CHUNK_LIST_BASE_CAPACITY  64
+#define SLOT_BASE_CAPACITY        128
+#define DIRTY_QUEUE_BASE_CAPACITY 64
+
+// Floor division, so negative block coordinates land in the chunk below them
+static int chunk_coordinate(int block) { return block >= 0 ? block / CHUNK_SIZE : (block + 1) / CHUNK_SIZE - 1; }
+
+// Spreads the lower 32 bits of a value over the even bits of the result
+static uint64_t spread_bits(uint32_t value) {
+    uint64_t bits = value;
+    bits          = (bits | (bits << 16)) & 0x0000FFFF0000FFFFull;
+    bits          = (bits | (bits << 8)) & 0x00FF00FF00FF00FFull;
+    bits          = (bits | (bits << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    bits          = (bits | (bits << 2)) & 0x3333333333333333ull;
+    bits          = (bits | (bits << 1)) & 0x5555555555555555ull;
+    return bits;
+}
+
+// Morton code of a chunk position, coordinates are biased so negative positions interleave like positive ones
+static uint64_t chunk_key(int x, int z) {
+    return spread_bits((uint32_t)x ^ 0x80000000u) | (spread_bits((uint32_t)z ^ 0x80000000u) << 1);
+}
+
+// Fibonacci hashing, scrambles the Morton code so neighboring chunks do not cluster in the table
+static size_t slot_index(world_t *world, uint64_t key) {
+    return (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & (world->slot_capacity - 1);
+}
+
+static world_chunk_slot_t *find_slot(world_t *world, uint64_t key) {
+    size_t index = slot_index(world, key);
+    while (world->slots[index].chunk && world->slots[index].key != key) {
+        index = (index + 1) & (world->slot_capacity - 1);
+    }
+    return &world->slots[index];
+}
+
+static int grow_slots(world_t *world) {
+    size_t old_capacity           = world->slot_capacity;
+    world_chunk_slot_t *old_slots = world->slots;
+    size_t capacity               = old_capacity ? old_capacity * 2 : SLOT_BASE_CAPACITY;
+    world_chunk_slot_t *slots     = calloc(capacity, sizeof(world_chunk_slot_t));
+    if (slots == NULL) {
+        LOG_ERROR("Failed to grow the chunk map");
+        return -1;
+    }
+
+    world->slots         = slots;
+    world->slot_capacity = capacity;
+    for (size_t i = 0; i < old_capacity; ++i) {
+        if (old_slots[i].chunk) {
+            *find_slot(world, old_slots[i].key) = old_slots[i];
+        }
+    }
+
+    free(old_slots);
+    return 0;
+}
+
+// Backward shift deletion, keeps probe sequences intact without tombstones
+static void remove_slot(world_t *world, world_chunk_slot_t *slot) {
+    size_t mask = world->slot_capacity - 1;
+    size_t hole = slot - world->slots;
+    size_t next = (hole + 1) & mask;
+
+    while (world->slots[next].chunk) {
+        size_t home = slot_index(world, world->slots[next].key);
+        // Move the entry into the hole unless its home lies cyclically in (hole, next]
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            world->slots[hole] = world->slots[next];
+            hole               = next;
+        }
+        next = (next + 1) & mask;
+    }
+
+    world->slots[hole].chunk = NULL;
+}
+
+// Offsets of the neighbors, indexed by `enum chunk_neighbor`
+static const ivec2s neighbor_offsets[4] = {
+    [CHUNK_NEIGHBOR_FRONT] = {{0, 1}},
+    [CHUNK_NEIGHBOR_BACK]  = {{0, -1}},
+    [CHUNK_NEIGHBOR_LEFT]  = {{-1, 0}},
+    [CHUNK_NEIGHBOR_RIGHT] = {{1, 0}},
+};
+
+// The neighbor on the opposite side, FRONT <-> BACK and LEFT <-> RIGHT
+static int opposite_neighbor(int neighbor) { return neighbor ^ 1; }
+
+// Every section of a neighbor may have faces on the shared border, so the whole neighbor is remeshed. Neighbors that
+// are not meshed yet are queued by the pipeline once ready, and busy ones by the job holding them.
+static void invalidate_neighbor(world_t *world, chunk_t *neighbor) {
+    if (neighbor->stage != CHUNK_STAGE_MESHED || chunk_is_busy(neighbor)) {
+        return;
+    }
+
+    for (int s = 0; s < CHUNK_SECTION_COUNT; ++s) {
+        neighbor->sections[s].dirty = 1;
+    }
+    neighbor->dirty = 1;
+    world_queue_dirty_chunk(world, neighbor);
+}
+
 world_t *world_create(world_settings_t settings) {
-    world_t *world = malloc(sizeof(world_t));
-    world->size    = settings.size;
-    world->chunks  = malloc(world->size * world->size * sizeof(chunk_t *));
-
-    for (int x = 0; x < world->size; x++) {
-        for (int y = 0; y < world->size; y++) {
-            chunk_t *chunk                     = chunk_create((ivec2s) {{x, y}});
-            world->chunks[x + y * world->size] = chunk;
-
-            for (size_t i = 0; i < CHUNK_VOLUME; ++i) {
-                int y = (i / CHUNK_SIZE) % CHUNK_HEIGHT;
-                if (y > 64) {
-                    chunk->blocks[i] = BLOCK_ID_AIR;
-                    continue;
-                } else if (y > 63) {
-                    chunk->blocks[i] = BLOCK_ID_GRASS;
-                    continue;
-                } else if (y > 59) {
-                    chunk->blocks[i] = BLOCK_ID_DIRT;
-                    continue;
-                } else if (y > 54) {
-                    chunk->blocks[i] = BLOCK_ID_COBBLESTONE;
-                    continue;
-                }
-                chunk->blocks[i] = BLOCK_ID_STONE;
+    world_t *world = calloc(1, sizeof(world_t));
+    if (world == NULL) {
+        LOG_ERROR("Failed to allocate world");
+        return NULL;
+    }
+
+    terrain_init(&world->terrain, settings.seed);
+
+    for (int x = 0; x < settings.size; x++) {
+        for (int y = 0; y < settings.size; y++) {
+            if (world_load_chunk(world, (ivec2s) {{x, y}}) == NULL) {
+                world_destroy(world);
+                return NULL;
             }
         }
     }
@@ -43,11 +133,13 @@ void world_destroy(world_t *world) {
         return;
     }
 
-    for (size_t i = 0; i < world->size * world->size; ++i) {
+    for (size_t i = 0; i < world->chunk_count; ++i) {
         chunk_destroy(world->chunks[i]);
     }
 
     free(world->chunks);
+    free(world->slots);
+    free(world->dirty_chunks);
     free(world);
 }
 
@@ -57,9 +149,203 @@ chunk_t *world_get_chunk(world_t *world, int x, int y) {
         return NULL;
     }
 
-    if (x < 0 || x >= world->size || y < 0 || y >= world->size) {
+    if (world->slot_capacity == 0) {
+        return NULL;
+    }
+
+    return find_slot(world, chunk_key(x, y))->chunk;
+}
+
+chunk_t *world_load_chunk(world_t *world, ivec2s position) {
+    if (world == NULL) {
+        LOG_ERROR("'world_load_chunk' called with NULL world");
         return NULL;
     }
 
-    return world->chunks[x + y * world->size];
+    chunk_t *existing = world_get_chunk(world, position.x, position.y);
+    if (existing) {
+        return existing;
+    }
+
+    // Keep the map at most half full so probe sequences stay short
+    if ((world->chunk_count + 1) * 2 > world->slot_capacity && grow_slots(world) != 0) {
+        return NULL;
+    }
+
+    if (world->chunk_count == world->chunk_capacity) {
+        size_t capacity  = world->chunk_capacity ? world->chunk_capacity * 2 : CHUNK_LIST_BASE_CAPACITY;
+        chunk_t **chunks = realloc(world->chunks, capacity * sizeof(chunk_t *));
+        if (chunks == NULL) {
+            LOG_ERROR("Failed to grow the chunk list");
+            return NULL;
+        }
+        world->chunks         = chunks;
+        world->chunk_capacity = capacity;
+    }
+
+    chunk_t *chunk = chunk_create(position);
+    if (chunk == NULL) {
+        return NULL;
+    }
+
+    uint64_t key             = chunk_key(position.x, position.y);
+    world_chunk_slot_t *slot = find_slot(world, key);
+    slot->key                = key;
+    slot->chunk              = chunk;
+
+    chunk->world_index                  = world->chunk_count;
+    world->chunks[world->chunk_count++] = chunk;
+
+    for (int i = 0; i < 4; ++i) {
+        chunk_t *neighbor =
+            world_get_chunk(world, position.x + neighbor_offsets[i].x, position.y + neighbor_offsets[i].y);
+        chunk->neighbors[i] = neighbor;
+        if (neighbor) {
+            neighbor->neighbors[opposite_neighbor(i)] = chunk;
+            invalidate_neighbor(world, neighbor);
+        }
+    }
+
+    return chunk;
+}
+
+int world_unload_chunk(world_t *world, chunk_t *chunk) {
+    if (world == NULL) {
+        LOG_ERROR("'world_unload_chunk' called with NULL world");
+        return -1;
+    }
+
+    if (chunk == NULL) {
+        LOG_ERROR("'world_unload_chunk' called with NULL chunk");
+        return -1;
+    }
+
+    if (chunk->meshing || chunk_is_busy(chunk)) {
+        return -1;
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        chunk_t *neighbor = chunk->neighbors[i];
+        if (neighbor) {
+            neighbor->neighbors[opposite_neighbor(i)] = NULL;
+            invalidate_neighbor(world, neighbor);
+        }
+    }
+
+    if (chunk->queued) {
+        for (size_t i = 0; i < world->dirty_count; ++i) {
+            if (world->dirty_chunks[i] == chunk) {
+                world->dirty_chunks[i] = world->dirty_chunks[--world->dirty_count];
+                break;
+            }
+        }
+    }
+
+    remove_slot(world, find_slot(world, chunk_key(chunk->position.x, chunk->position.y)));
+
+    chunk_t *last                     = world->chunks[--world->chunk_count];
+    world->chunks[chunk->world_index] = last;
+    last->world_index                 = chunk->world_index;
+
+    chunk_destroy(chunk);
+    return 0;
+}
+
+block_id_t world_get_block(world_t *world, ivec3s position) {
+    if (world == NULL) {
+        LOG_ERROR("'world_get_block' called with NULL world");
+        return BLOCK_ID_AIR;
+    }
+
+    int chunk_x    = chunk_coordinate(position.x);
+    int chunk_z    = chunk_coordinate(position.z);
+    chunk_t *chunk = world_get_chunk(world, chunk_x, chunk_z);
+    if (chunk == NULL || chunk_is_busy(chunk)) {
+        return BLOCK_ID_AIR;
+    }
+
+    ivec3s local = (ivec3s) {{position.x - chunk_x * CHUNK_SIZE, position.y, position.z - chunk_z * CHUNK_SIZE}};
+    return chunk_get_block(chunk, local);
+}
+
+// Like `invalidate_neighbor`, neighbors that are not meshed yet get their whole mesh built anyway and busy ones may be
+// written by a worker
+static void mark_neighbor_dirty(world_t *world, chunk_t *neighbor, int section) {
+    if (neighbor == NULL || neighbor->stage != CHUNK_STAGE_MESHED || chunk_is_busy(neighbor)) {
+        return;
+    }
+
+    neighbor->sections[section].dirty = 1;
+    neighbor->dirty                   = 1;
+    world_queue_dirty_chunk(world, neighbor);
+}
+
+void world_set_block(world_t *world, ivec3s position, block_id_t block) {
+    if (world == NULL) {
+        LOG_ERROR("'world_set_block' called with NULL world");
+        return;
+    }
+
+    if (position.y < 0 || position.y >= CHUNK_HEIGHT) {
+        return;
+    }
+
+    int chunk_x    = chunk_coordinate(position.x);
+    int chunk_z    = chunk_coordinate(position.z);
+    chunk_t *chunk = world_get_chunk(world, chunk_x, chunk_z);
+    if (chunk == NULL || chunk_is_busy(chunk) || chunk->stage < CHUNK_STAGE_DECORATED) {
+        return;
+    }
+
+    ivec3s local = (ivec3s) {{position.x - chunk_x * CHUNK_SIZE, position.y, position.z - chunk_z * CHUNK_SIZE}};
+    if (chunk_get_block(chunk, local) == block) {
+        return;
+    }
+
+    chunk_set_block(chunk, local, block);
+    world_queue_dirty_chunk(world, chunk);
+
+    // Faces across a chunk border are meshed by the neighbor, which only needs the section sharing the edited block
+    int section = position.y / CHUNK_SECTION_HEIGHT;
+    if (local.x == 0) {
+        mark_neighbor_dirty(world, chunk->neighbors[CHUNK_NEIGHBOR_LEFT], section);
+    } else if (local.x == CHUNK_SIZE - 1) {
+        mark_neighbor_dirty(world, chunk->neighbors[CHUNK_NEIGHBOR_RIGHT], section);
+    }
+
+    if (local.z == 0) {
+        mark_neighbor_dirty(world, chunk->neighbors[CHUNK_NEIGHBOR_BACK], section);
+    } else if (local.z == CHUNK_SIZE - 1) {
+        mark_neighbor_dirty(world, chunk->neighbors[CHUNK_NEIGHBOR_FRONT], section);
+    }
+}
+
+void world_queue_dirty_chunk(world_t *world, chunk_t *chunk) {
+    if (world == NULL) {
+        LOG_ERROR("'world_queue_dirty_chunk' called with NULL world");
+        return;
+    }
+
+    if (chunk == NULL) {
+        LOG_ERROR("'world_queue_dirty_chunk' called with NULL chunk");
+        return;
+    }
+
+    if (chunk->queued) {
+        return;
+    }
+
+    if (world->dirty_count == world->dirty_capacity) {
+        size_t capacity = world->dirty_capacity ? world->dirty_capacity * 2 : DIRTY_QUEUE_BASE_CAPACITY;
+        chunk_t **queue = realloc(world->dirty_chunks, capacity * sizeof(chunk_t *));
+        if (queue == NULL) {
+            LOG_ERROR("Failed to grow the dirty chunk queue");
+            return;
+        }
+        world->dirty_chunks   = queue;
+        world->dirty_capacity = capacity;
+    }
+
+    world->dirty_chunks[world->dirty_count++] = chunk;
+    chunk->queued                             = 1;
 }
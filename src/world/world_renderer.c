@@ -1,21 +1,461 @@
 #include "world/world_renderer.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/arena.h"
+#include "core/job_system.h"
 #include "core/log.h"
 #include "core/profiling.h"
+#include "graphics/frustum.h"
+#include "graphics/occlusion_query.h"
 #include "graphics/renderer.h"
+#include "world/chunk_mesher.h"
+#include "world/chunk_pipeline.h"
+#include "world/chunk_visibility.h"
+#include "world/world_streamer.h"
+
+typedef struct {
+    world_renderer_state_t *state;
+
+    // Live world and chunk, only touched on the main thread
+    world_t *world;
+    chunk_t *chunk;
+
+    // Worker side input and output
+    chunk_snapshot_t snapshot;
+    chunk_mesh_data_t data;
+    int failed;
+
+    // Squared distance in chunks to the camera's chunk, uploads of the nearest chunks go first
+    int distance;
+} mesh_job_t;
+
+// Section reached by the visibility search
+typedef struct {
+    chunk_t *chunk;
+    int section;
+
+    // Face the search entered the section through, `CHUNK_FACE_COUNT` for the camera's section
+    int entry;
+
+    // Directions travelled to reach the section as `1 << face`, turning back against one of them reveals nothing new
+    uint8_t directions;
+} visibility_node_t;
+
+// Chunk drawn after the others because its bounds are queried this frame
+typedef struct {
+    chunk_t *chunk;
+    vec3s min;
+    vec3s max;
+
+    renderer_index_range_t ranges[CHUNK_SECTION_COUNT];
+    size_t range_count;
+
+    // Set if the chunk was hidden, it is then only drawn if its query passes
+    int hidden;
+
+    // Set if a new query is issued, hidden chunks whose last query is still on its way are drawn against that one
+    int query;
+} deferred_draw_t;
 
 struct world_renderer_state {
     tilemap_t *tilemap;
     shader_program_t *block_shader;
     int draw_distance;
+    chunk_mesh_mode_t mesh_mode;
+
+    // Meshing scratch arenas, one per job system worker index
+    arena_t *mesh_scratch;
+    int mesh_scratch_count;
+
+    // Main thread scratch for patching single sections
+    arena_t section_scratch;
+
+    // Mesh jobs submitted and not uploaded yet
+    job_counter_t mesh_jobs;
+
+    // Vertices of every meshed chunk, drawn through a single vertex array
+    vertex_pool_t *chunk_pool;
+
+    // Built meshes waiting for their upload, spread over frames by the staging ring's per frame budget
+    staging_ring_t *staging;
+    mesh_job_t **pending_uploads;
+    size_t pending_count;
+    size_t pending_capacity;
+
+    // Sections drawn by the single multi-draw of the visible chunks, and by the conditional draw of a hidden one
+    renderer_draw_batch_t chunk_batch;
+    renderer_draw_batch_t conditional_batch;
+
+    chunk_pipeline_t *pipeline;
+
+    // Loads and unloads chunks around the chunk the camera was in when the last frame was rendered
+    world_streamer_t *streamer;
+    ivec2s camera_chunk;
+    int has_camera;
+
+    // Frustum culling input rebuilt every frame: the columns of the meshed chunks within the draw distance, then the
+    // meshed sections of the columns that passed
+    chunk_t **candidates;
+    size_t candidate_capacity;
+
+    // Sections reached from the camera's section through open space are marked with the current frame. Only those are
+    // drawn when `visibility_searched` is set, otherwise the camera is outside of the loaded world and all of them are.
+    visibility_node_t *visit_queue;
+    size_t visit_capacity;
+    uint32_t frame;
+    int visibility_searched;
+
+    // Unit cube drawn for occlusion queries, NULL if they are disabled
+    mesh_t *bounds_mesh;
+
+    // Chunks whose bounds are queried after the visible chunks are drawn
+    deferred_draw_t *deferred;
+    size_t deferred_count;
+    size_t deferred_capacity;
+
+    aabb_list_t chunk_bounds;
+    aabb_list_t section_bounds;
 };
 
+// Chunks with more dirty sections than this are rebuilt on the workers instead of patched section by section
+#define INCREMENTAL_SECTION_LIMIT 4
+
+// Chunks are unloaded this many chunks past the load radius, so crossing a chunk border back and forth does not
+// reload the edge of the world every frame
+#define STREAM_HYSTERESIS 2
+
+// Chunks loaded and unloaded per frame, keeps terrain generation from stalling a frame when the camera moves fast
+#define STREAM_LOADS_PER_FRAME   8
+#define STREAM_UNLOADS_PER_FRAME 16
+
+// Vertices the chunk pool starts out with, enough for a few hundred chunks, it grows when they do not fit
+#define CHUNK_POOL_BASE_CAPACITY (1 << 20)
+
+// Vertices moved per frame to close the holes remeshed and unloaded chunks leave in the chunk pool
+#define CHUNK_POOL_DEFRAGMENT_BUDGET (1 << 16)
+
+// Bytes of chunk vertices uploaded per frame, a burst of remeshed chunks is spread over the following frames
+#define CHUNK_UPLOAD_BUDGET (4 << 20)
+
+// Visible chunks tend to stay visible, so their bounds are only queried once every this many frames, staggered over
+// the chunks. Hidden chunks are queried every frame since their draw depends on it.
+#define OCCLUSION_REQUERY_INTERVAL 8
+
+// Chunks with the camera this close to their bounds are always drawn, the near plane clips their bounds and the query
+// would report them hidden
+#define OCCLUSION_CAMERA_MARGIN 1.0f
+
+// Queried bounds are grown by this much, so faces lying on the bounds do not fight the depth test against them
+#define OCCLUSION_BOUNDS_PADDING 0.05f
+
+// Uploads the built vertices and releases the job, the chunk can be meshed again afterwards
+static void upload_mesh(mesh_job_t *job, staging_ring_t *staging) {
+    if (job->failed || chunk_upload_mesh(job->chunk, &job->data, job->state->chunk_pool, staging) != 0) {
+        job->chunk->dirty = 1;
+        world_queue_dirty_chunk(job->world, job->chunk);
+    }
+    job->chunk->meshing = 0;
+
+    free(job->data.vertices);
+    free(job);
+}
+
+// Runs on the main thread once the vertices are built, queues them for `upload_pending_meshes`
+static void mesh_job_finish(void *arg, int worker) {
+    mesh_job_t *job               = arg;
+    world_renderer_state_t *state = job->state;
+    (void)worker;
+
+    if (job->failed) {
+        upload_mesh(job, NULL);
+        return;
+    }
+
+    if (state->pending_count == state->pending_capacity) {
+        size_t capacity      = state->pending_capacity ? state->pending_capacity * 2 : 64;
+        mesh_job_t **uploads = realloc(state->pending_uploads, capacity * sizeof(mesh_job_t *));
+        if (uploads == NULL) {
+            LOG_ERROR("Failed to grow the pending mesh uploads");
+            upload_mesh(job, NULL);
+            return;
+        }
+        state->pending_uploads  = uploads;
+        state->pending_capacity = capacity;
+    }
+
+    state->pending_uploads[state->pending_count++] = job;
+}
+
+static int compare_upload_distance(const void *a, const void *b) {
+    const mesh_job_t *job_a = *(mesh_job_t *const *)a;
+    const mesh_job_t *job_b = *(mesh_job_t *const *)b;
+    return (job_a->distance > job_b->distance) - (job_a->distance < job_b->distance);
+}
+
+// Uploads the pending meshes nearest to the camera first, until the staging ring has no room left this frame. A mesh
+// larger than a whole frame's budget never fits the ring, it is uploaded directly as the only upload of a frame.
+static int upload_pending_meshes(world_renderer_state_t *state) {
+    if (state->pending_count == 0) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < state->pending_count; ++i) {
+        mesh_job_t *job = state->pending_uploads[i];
+        int dx          = job->chunk->position.x - state->camera_chunk.x;
+        int dz          = job->chunk->position.y - state->camera_chunk.y;
+        job->distance   = dx * dx + dz * dz;
+    }
+    qsort(state->pending_uploads, state->pending_count, sizeof(mesh_job_t *), compare_upload_distance);
+
+    staging_ring_begin_frame(state->staging);
+
+    size_t capacity = staging_ring_get_capacity(state->staging);
+    size_t uploaded = 0;
+    while (uploaded < state->pending_count) {
+        mesh_job_t *job = state->pending_uploads[uploaded];
+        size_t size     = job->data.vertex_count * sizeof(chunk_vertex_t);
+        if (size > capacity) {
+            if (uploaded > 0) {
+                break;
+            }
+
+            upload_mesh(job, NULL);
+            ++uploaded;
+            break;
+        }
+
+        if (size > staging_ring_get_available(state->staging)) {
+            break;
+        }
+
+        upload_mesh(job, state->staging);
+        ++uploaded;
+    }
+
+    staging_ring_end_frame(state->staging);
+
+    state->pending_count -= uploaded;
+    memmove(state->pending_uploads, state->pending_uploads + uploaded, state->pending_count * sizeof(mesh_job_t *));
+    return uploaded > 0;
+}
+
+static void mesh_job_run(void *arg, int worker) {
+    mesh_job_t *job  = arg;
+    arena_t *scratch = &job->state->mesh_scratch[worker];
+
+    chunk_mesh_data_t data;
+    job->failed = chunk_build_mesh(&job->snapshot.chunk, job->snapshot.neighbor_pointers, job->state->mesh_mode,
+                                   scratch, &data) != 0;
+
+    // The scratch arena is reused by the next job, hand the vertices over in an exactly sized buffer
+    if (!job->failed) {
+        job->data          = data;
+        job->data.vertices = NULL;
+        if (data.vertex_count > 0) {
+            job->data.vertices = malloc(data.vertex_count * sizeof(chunk_vertex_t));
+            if (job->data.vertices == NULL) {
+                LOG_ERROR("Failed to allocate chunk vertices");
+                job->failed = 1;
+            } else {
+                memcpy(job->data.vertices, data.vertices, data.vertex_count * sizeof(chunk_vertex_t));
+            }
+        }
+    }
+
+    arena_reset(scratch);
+    chunk_snapshot_free(&job->snapshot);
+
+    // Without the upload the mesh is dropped, the chunk keeps its current mesh and is remeshed on its next change
+    job_t upload = {mesh_job_finish, job, JOB_PRIORITY_HIGH, &job->state->mesh_jobs};
+    if (job_system_submit_main_thread(&upload) != 0) {
+        LOG_ERROR("Failed to queue the mesh upload of chunk (%d, %d)", job->chunk->position.x, job->chunk->position.y);
+        __atomic_store_n(&job->chunk->dirty, 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&job->chunk->meshing, 0, __ATOMIC_RELEASE);
+        free(job->data.vertices);
+        free(job);
+    }
+}
+
+static int submit_mesh_job(world_renderer_t *renderer, world_t *world, chunk_t *chunk) {
+    world_renderer_state_t *state = renderer->state;
+
+    mesh_job_t *job = calloc(1, sizeof(mesh_job_t));
+    if (job == NULL) {
+        LOG_ERROR("Failed to allocate mesh job");
+        return -1;
+    }
+    job->state = state;
+    job->world = world;
+    job->chunk = chunk;
+
+    if (chunk_snapshot_create(&job->snapshot, chunk, chunk->neighbors) != 0) {
+        free(job);
+        return -1;
+    }
+
+    job_t build = {mesh_job_run, job, JOB_PRIORITY_HIGH, &state->mesh_jobs};
+    if (job_system_submit(&build) != 0) {
+        chunk_snapshot_free(&job->snapshot);
+        free(job);
+        return -1;
+    }
+
+    // Changes made from now on are not part of the snapshot and mark the chunk dirty again
+    chunk->dirty   = 0;
+    chunk->meshing = 1;
+    for (int s = 0; s < CHUNK_SECTION_COUNT; ++s) {
+        chunk->sections[s].dirty = 0;
+    }
+
+    return 0;
+}
+
+// Checks if the pipeline is working on the blocks of the chunk or of the neighbors its mesh reads
+static int neighborhood_busy(chunk_t *chunk) {
+    if (chunk_is_busy(chunk)) {
+        return 1;
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        if (chunk->neighbors[i] && chunk_is_busy(chunk->neighbors[i])) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Patches the dirty sections of an already meshed chunk in place, fails if the chunk needs a full rebuild
+static int update_dirty_sections(world_renderer_t *renderer, chunk_t *chunk) {
+    world_renderer_state_t *state = renderer->state;
+
+    int dirty_count = 0;
+    for (int s = 0; s < CHUNK_SECTION_COUNT; ++s) {
+        dirty_count += chunk->sections[s].dirty;
+    }
+
+    if (!chunk->has_mesh || dirty_count > INCREMENTAL_SECTION_LIMIT) {
+        return -1;
+    }
+
+    for (int s = 0; s < CHUNK_SECTION_COUNT; ++s) {
+        if (!chunk->sections[s].dirty) {
+            continue;
+        }
+
+        int result = chunk_update_section_mesh(chunk, s, chunk->neighbors, state->mesh_mode, &state->section_scratch);
+        arena_reset(&state->section_scratch);
+        if (result != 0) {
+            return -1;
+        }
+    }
+
+    chunk->dirty = 0;
+    return 0;
+}
+
 world_renderer_t *world_renderer_create(world_renderer_settings_t settings) {
     world_renderer_t *renderer     = malloc(sizeof(world_renderer_t));
-    renderer->state                = malloc(sizeof(world_renderer_state_t));
+    renderer->state                = calloc(1, sizeof(world_renderer_state_t));
     renderer->state->tilemap       = settings.tilemap;
     renderer->state->block_shader  = settings.block_shader;
     renderer->state->draw_distance = settings.draw_distance;
+    renderer->state->mesh_mode     = settings.mesh_mode;
+
+    // Chunks within the draw distance of the camera's chunk, plus the ring partially inside it and the rings the
+    // pipeline needs to get them meshed
+    world_streamer_settings_t streamer_settings = {0};
+    streamer_settings.load_radius               = settings.draw_distance + 1 + CHUNK_PIPELINE_MARGIN;
+    streamer_settings.unload_radius             = streamer_settings.load_radius + STREAM_HYSTERESIS;
+    streamer_settings.loads_per_update          = STREAM_LOADS_PER_FRAME;
+    streamer_settings.unloads_per_update        = STREAM_UNLOADS_PER_FRAME;
+    renderer->state->streamer                   = world_streamer_create(streamer_settings);
+    if (renderer->state->streamer == NULL) {
+        LOG_ERROR("Failed to create the world streamer");
+        world_renderer_destroy(renderer);
+        return NULL;
+    }
+
+    int worker_count          = job_system_get_worker_count();
+    renderer->state->pipeline = chunk_pipeline_create(worker_count * 2);
+    if (renderer->state->pipeline == NULL) {
+        LOG_ERROR("Failed to create the chunk pipeline");
+        world_renderer_destroy(renderer);
+        return NULL;
+    }
+
+    renderer->state->mesh_scratch = calloc(worker_count, sizeof(arena_t));
+    if (renderer->state->mesh_scratch == NULL) {
+        LOG_ERROR("Failed to allocate the meshing scratch arenas");
+        world_renderer_destroy(renderer);
+        return NULL;
+    }
+
+    vertex_layout_t chunk_layout = CHUNK_VERTEX_LAYOUT_INIT;
+    renderer->state->chunk_pool  = vertex_pool_create(&chunk_layout, CHUNK_POOL_BASE_CAPACITY);
+    if (renderer->state->chunk_pool == NULL) {
+        LOG_ERROR("Failed to create the chunk vertex pool");
+        world_renderer_destroy(renderer);
+        return NULL;
+    }
+
+    renderer->state->staging = staging_ring_create(CHUNK_UPLOAD_BUDGET);
+    if (renderer->state->staging == NULL) {
+        LOG_ERROR("Failed to create the chunk staging ring");
+        world_renderer_destroy(renderer);
+        return NULL;
+    }
+
+    if (renderer_draw_batch_init(&renderer->state->chunk_batch, 0) != 0 ||
+        renderer_draw_batch_init(&renderer->state->conditional_batch, CHUNK_SECTION_COUNT) != 0) {
+        LOG_ERROR("Failed to allocate the chunk draw batches");
+        world_renderer_destroy(renderer);
+        return NULL;
+    }
+
+    if (aabb_list_init(&renderer->state->chunk_bounds, 0) != 0 ||
+        aabb_list_init(&renderer->state->section_bounds, 0) != 0) {
+        LOG_ERROR("Failed to allocate the culling bounds");
+        world_renderer_destroy(renderer);
+        return NULL;
+    }
+
+    if (arena_init(&renderer->state->section_scratch, CHUNK_SECTION_SCRATCH_SIZE) != 0) {
+        LOG_ERROR("Failed to allocate the section scratch arena");
+        world_renderer_destroy(renderer);
+        return NULL;
+    }
+
+    for (int i = 0; i < worker_count; ++i) {
+        if (arena_init(&renderer->state->mesh_scratch[i], CHUNK_MESH_SCRATCH_SIZE) != 0) {
+            LOG_ERROR("Failed to allocate the meshing scratch arena");
+            world_renderer_destroy(renderer);
+            return NULL;
+        }
+        ++renderer->state->mesh_scratch_count;
+    }
+
+    if (settings.bounds_shader) {
+        vertex_t vertices[8];
+        for (int i = 0; i < 8; ++i) {
+            vertices[i] = (vertex_t) {{{i & 1, i >> 1 & 1, i >> 2 & 1}}, GLMS_VEC2_ZERO_INIT};
+        }
+
+        uint32_t indices[36] = {0, 1, 3, 3, 2, 0, 4, 6, 7, 7, 5, 4, 0, 4, 5, 5, 1, 0,
+                                2, 3, 7, 7, 6, 2, 0, 2, 6, 6, 4, 0, 1, 5, 7, 7, 3, 1};
+        renderer->state->bounds_mesh =
+            mesh_create(NULL, vertices, 8, indices, 36, settings.bounds_shader, settings.tilemap->texture);
+    }
+
+    // Chunk vertices only carry tile ids, the vertex shader resolves them against the tilemap layout
+    int tiles_per_row = settings.tilemap->map_size / settings.tilemap->tile_size;
+    shader_program_set_int(settings.block_shader, "tilesPerRow", tiles_per_row);
+    shader_program_set_float(settings.block_shader, "pixelSize", 1.0f / settings.tilemap->map_size);
+
+    // Chunk positions come from the origins of their pool ranges
+    shader_program_set_int(settings.block_shader, "origins", VERTEX_POOL_ORIGIN_SLOT);
+    shader_program_set_int(settings.block_shader, "poolPageSize", VERTEX_POOL_PAGE_SIZE);
     return renderer;
 }
 
@@ -25,7 +465,69 @@ void world_renderer_destroy(world_renderer_t *renderer) {
         return;
     }
 
-    free(renderer->state);
+    world_renderer_state_t *state = renderer->state;
+
+    // Finish every mesh in flight and drop the ones waiting for their upload, their chunks are never touched again
+    job_system_wait(&state->mesh_jobs);
+    for (size_t i = 0; i < state->pending_count; ++i) {
+        state->pending_uploads[i]->chunk->meshing = 0;
+        free(state->pending_uploads[i]->data.vertices);
+        free(state->pending_uploads[i]);
+    }
+    free(state->pending_uploads);
+
+    if (state->staging) {
+        staging_ring_destroy(state->staging);
+    }
+
+    if (state->pipeline) {
+        chunk_pipeline_destroy(state->pipeline);
+    }
+
+    if (state->streamer) {
+        world_streamer_destroy(state->streamer);
+    }
+
+    for (int i = 0; i < state->mesh_scratch_count; ++i) {
+        arena_t *scratch = &state->mesh_scratch[i];
+        LOG_DEBUG("Mesh scratch %d: %zu bytes in %zu allocations served without the heap, peak %zu of %zu bytes", i,
+                  scratch->allocated, scratch->allocation_count, scratch->peak, scratch->capacity);
+        arena_free(scratch);
+    }
+    free(state->mesh_scratch);
+
+    if (state->section_scratch.data) {
+        arena_free(&state->section_scratch);
+    }
+
+    // The chunks outlive the renderer, destroying the pool detaches their vertices
+    if (state->chunk_pool) {
+        LOG_DEBUG("Chunk pool: %zu of %zu vertices in use", vertex_pool_get_used(state->chunk_pool),
+                  vertex_pool_get_capacity(state->chunk_pool));
+        vertex_pool_destroy(state->chunk_pool);
+    }
+
+    if (state->chunk_batch.counts) {
+        renderer_draw_batch_free(&state->chunk_batch);
+    }
+    if (state->conditional_batch.counts) {
+        renderer_draw_batch_free(&state->conditional_batch);
+    }
+
+    free(state->candidates);
+    free(state->deferred);
+    if (state->bounds_mesh) {
+        mesh_destroy(state->bounds_mesh);
+    }
+    free(state->visit_queue);
+    if (state->chunk_bounds.min_x) {
+        aabb_list_free(&state->chunk_bounds);
+    }
+    if (state->section_bounds.min_x) {
+        aabb_list_free(&state->section_bounds);
+    }
+
+    free(state);
     free(renderer);
 }
 
@@ -40,46 +542,159 @@ void world_renderer_prepare(world_renderer_t *renderer, world_t *world) {
         return;
     }
 
-    int profile_id = profiling_begin("Mesh generation");
-    int rendered   = 0;
-
-    for (size_t i = 0; i < world->size * world->size; ++i) {
-        chunk_t *chunk = world->chunks[i];
-        if (chunk->dirty) {
-            rendered = 1;
-
-            chunk_t *neighbors[4];
-            neighbors[CHUNK_NEIGHBOR_FRONT] = world_get_chunk(world, chunk->position.x, chunk->position.y + 1);
-            neighbors[CHUNK_NEIGHBOR_BACK]  = world_get_chunk(world, chunk->position.x, chunk->position.y - 1);
-            neighbors[CHUNK_NEIGHBOR_LEFT]  = world_get_chunk(world, chunk->position.x - 1, chunk->position.y);
-            neighbors[CHUNK_NEIGHBOR_RIGHT] = world_get_chunk(world, chunk->position.x + 1, chunk->position.y);
+    world_renderer_state_t *state = renderer->state;
 
-            chunk_generate_mesh(chunk, renderer->state->block_shader, renderer->state->tilemap, neighbors);
+    if (state->has_camera) {
+        int profile_id = profiling_begin("Chunk streaming");
+        if (world_streamer_update(state->streamer, world, state->camera_chunk)) {
+            profiling_end(profile_id);
+        } else {
+            profiling_cancel(profile_id);
         }
     }
 
-    if (rendered) {
+    // Advance chunks through generation, decoration and lighting on the workers. Finished meshes are queued by their
+    // main thread jobs and uploaded below.
+    chunk_pipeline_update(state->pipeline, world);
+
+    int profile_id = profiling_begin("Chunk uploads");
+    if (upload_pending_meshes(state)) {
         profiling_end(profile_id);
     } else {
         profiling_cancel(profile_id);
     }
+
+    // Patch small edits in place and hand everything else over to the workers. Chunks still being meshed or with
+    // blocks busy in the pipeline stay queued until their jobs land, chunks not through the pipeline yet are requeued
+    // by it once ready.
+    size_t kept = 0;
+    for (size_t i = 0; i < world->dirty_count; ++i) {
+        chunk_t *chunk = world->dirty_chunks[i];
+        int done       = !chunk->dirty || chunk->stage != CHUNK_STAGE_MESHED;
+        if (!done && !chunk->meshing && !neighborhood_busy(chunk)) {
+            done = update_dirty_sections(renderer, chunk) == 0 || submit_mesh_job(renderer, world, chunk) == 0;
+        }
+
+        if (done) {
+            chunk->queued = 0;
+        } else {
+            world->dirty_chunks[kept++] = chunk;
+        }
+    }
+    world->dirty_count = kept;
+
+    vertex_pool_defragment(state->chunk_pool, CHUNK_POOL_DEFRAGMENT_BUDGET);
 }
 
-void world_renderer_render(world_renderer_t *renderer, world_t *world, vec3s camera_position) {
-    if (renderer == NULL) {
-        LOG_ERROR("'world_renderer_render' called with NULL renderer");
-        return;
+// Breadth first search from the camera's section through the faces each section connects, marking the sections it
+// reaches with the current frame. Fails if the camera is not inside a meshed chunk.
+static int find_visible_sections(world_renderer_state_t *state, world_t *world, vec3s camera_position) {
+    int section    = (int)floorf(camera_position.y / CHUNK_SECTION_HEIGHT);
+    chunk_t *start = world_get_chunk(world, state->camera_chunk.x, state->camera_chunk.y);
+    if (start == NULL || !start->has_mesh || section < 0 || section >= CHUNK_SECTION_COUNT) {
+        return -1;
     }
 
-    if (world == NULL) {
-        LOG_ERROR("'world_renderer_render' called with NULL world");
-        return;
+    // Sections are queued at most once per frame
+    size_t capacity = world->chunk_count * CHUNK_SECTION_COUNT;
+    if (state->visit_capacity < capacity) {
+        visibility_node_t *queue = realloc(state->visit_queue, capacity * sizeof(visibility_node_t));
+        if (queue == NULL) {
+            LOG_ERROR("Failed to grow the visibility search queue");
+            return -1;
+        }
+        state->visit_queue    = queue;
+        state->visit_capacity = capacity;
+    }
+
+    int radius  = state->draw_distance + 1;
+    size_t head = 0;
+    size_t tail = 0;
+
+    start->sections[section].visit_frame = state->frame;
+    state->visit_queue[tail++]           = (visibility_node_t) {start, section, CHUNK_FACE_COUNT, 0};
+    while (head < tail) {
+        visibility_node_t node = state->visit_queue[head++];
+        uint32_t visibility    = node.chunk->sections[node.section].visibility;
+
+        for (int face = 0; face < CHUNK_FACE_COUNT; ++face) {
+            if (node.directions & (1 << (face ^ 1))) {
+                continue;
+            }
+
+            if (node.entry != CHUNK_FACE_COUNT && !(visibility & CHUNK_VISIBILITY_BIT(node.entry, face))) {
+                continue;
+            }
+
+            chunk_t *chunk = node.chunk;
+            int next       = node.section;
+            if (face == CHUNK_FACE_BOTTOM || face == CHUNK_FACE_TOP) {
+                next += face == CHUNK_FACE_TOP ? 1 : -1;
+            } else {
+                chunk = chunk->neighbors[face];
+            }
+
+            if (chunk == NULL || next < 0 || next >= CHUNK_SECTION_COUNT ||
+                chunk->sections[next].visit_frame == state->frame) {
+                continue;
+            }
+
+            int dx = chunk->position.x - state->camera_chunk.x;
+            int dz = chunk->position.y - state->camera_chunk.y;
+            if (dx * dx + dz * dz > radius * radius) {
+                continue;
+            }
+
+            chunk->sections[next].visit_frame = state->frame;
+            state->visit_queue[tail++] =
+                (visibility_node_t) {chunk, next, face ^ 1, (uint8_t)(node.directions | 1 << face)};
+        }
+    }
+
+    return 0;
+}
+
+static int section_drawable(world_renderer_state_t *state, chunk_section_t *section) {
+    return section->index_count > 0 && (!state->visibility_searched || section->visit_frame == state->frame);
+}
+
+// Vertical range of the sections to draw, fails if the chunk has nothing to draw
+static int chunk_drawn_sections(world_renderer_state_t *state, chunk_t *chunk, int *bottom, int *top) {
+    *bottom = CHUNK_SECTION_COUNT;
+    *top    = -1;
+    for (int s = 0; s < CHUNK_SECTION_COUNT; ++s) {
+        if (section_drawable(state, &chunk->sections[s])) {
+            *bottom = *bottom < s ? *bottom : s;
+            *top    = s;
+        }
+    }
+    return *top >= 0 ? 0 : -1;
+}
+
+// Collects the meshed chunks within the draw distance and the bounds of their columns
+static void collect_candidates(world_renderer_state_t *state, world_t *world, vec3s camera_position) {
+    // Last frame's candidates may have been unloaded since, nothing may walk them if this fails
+    state->chunk_bounds.count   = 0;
+    state->section_bounds.count = 0;
+
+    if (state->candidate_capacity < world->chunk_count) {
+        chunk_t **candidates = realloc(state->candidates, world->chunk_count * sizeof(chunk_t *));
+        if (candidates == NULL) {
+            LOG_ERROR("Failed to grow the culling candidates");
+            return;
+        }
+        state->candidates         = candidates;
+        state->candidate_capacity = world->chunk_count;
     }
 
-    for (size_t i = 0; i < world->size * world->size; ++i) {
+    for (size_t i = 0; i < world->chunk_count; ++i) {
         chunk_t *chunk = world->chunks[i];
 
-        vec3s position = (vec3s) {{chunk->position.x * CHUNK_SIZE, 0.0f, chunk->position.y * CHUNK_SIZE}};
+        int bottom, top;
+        if (!chunk->has_mesh || chunk_drawn_sections(state, chunk, &bottom, &top) != 0) {
+            continue;
+        }
+
         float closest_x =
             fmaxf(chunk->position.x * CHUNK_SIZE, fminf(camera_position.x, (chunk->position.x + 1) * CHUNK_SIZE));
         float closest_y = fmaxf(0.0f, fminf(camera_position.y, CHUNK_HEIGHT));
@@ -87,8 +702,219 @@ void world_renderer_render(world_renderer_t *renderer, world_t *world, vec3s cam
             fmaxf(chunk->position.y * CHUNK_SIZE, fminf(camera_position.z, (chunk->position.y + 1) * CHUNK_SIZE));
         float distance = sqrtf(powf(camera_position.x - closest_x, 2) + powf(camera_position.y - closest_y, 2) +
                                powf(camera_position.z - closest_z, 2));
-        if (distance < renderer->state->draw_distance * CHUNK_SIZE) {
-            renderer_draw_mesh(chunk->mesh, position, GLMS_VEC3_ZERO, GLMS_VEC3_ONE);
+        if (distance >= state->draw_distance * CHUNK_SIZE) {
+            continue;
+        }
+
+        vec3s min = {{chunk->position.x * CHUNK_SIZE, bottom * CHUNK_SECTION_HEIGHT, chunk->position.y * CHUNK_SIZE}};
+        vec3s max = {{min.x + CHUNK_SIZE, (top + 1) * CHUNK_SECTION_HEIGHT, min.z + CHUNK_SIZE}};
+        if (aabb_list_push(&state->chunk_bounds, min, max) != 0) {
+            return;
+        }
+        state->candidates[state->chunk_bounds.count - 1] = chunk;
+    }
+}
+
+static void batch_chunk_ranges(renderer_draw_batch_t *batch, chunk_t *chunk, const renderer_index_range_t *ranges,
+                               size_t range_count) {
+    for (size_t i = 0; i < range_count; ++i) {
+        if (renderer_draw_batch_push(batch, ranges[i], chunk->geometry.offset) != 0) {
+            return;
         }
     }
-}
\ No newline at end of file
+}
+
+// Reads back the last query of the chunk and decides whether its draw waits for a query issued this frame. Returns
+// non-zero if the chunk is not drawn right away.
+static int defer_chunk_draw(world_renderer_state_t *state, chunk_t *chunk, vec3s min, vec3s max, vec3s camera_position,
+                            const renderer_index_range_t *ranges, size_t range_count) {
+    if (chunk->occlusion_pending && occlusion_query_available(chunk->occlusion_query)) {
+        chunk->occluded          = !occlusion_query_passed(chunk->occlusion_query);
+        chunk->occlusion_pending = 0;
+    }
+
+    if (camera_position.x > min.x - OCCLUSION_CAMERA_MARGIN && camera_position.x < max.x + OCCLUSION_CAMERA_MARGIN &&
+        camera_position.y > min.y - OCCLUSION_CAMERA_MARGIN && camera_position.y < max.y + OCCLUSION_CAMERA_MARGIN &&
+        camera_position.z > min.z - OCCLUSION_CAMERA_MARGIN && camera_position.z < max.z + OCCLUSION_CAMERA_MARGIN) {
+        chunk->occluded = 0;
+        return 0;
+    }
+
+    uint32_t stagger = (uint32_t)(chunk->position.x * 3 + chunk->position.y * 5);
+    if (!chunk->occluded && (chunk->occlusion_pending || (state->frame + stagger) % OCCLUSION_REQUERY_INTERVAL != 0)) {
+        return 0;
+    }
+
+    if (state->deferred_count == state->deferred_capacity) {
+        size_t capacity           = state->deferred_capacity ? state->deferred_capacity * 2 : 64;
+        deferred_draw_t *deferred = realloc(state->deferred, capacity * sizeof(deferred_draw_t));
+        if (deferred == NULL) {
+            LOG_ERROR("Failed to grow the deferred chunk draws");
+            return 0;
+        }
+        state->deferred          = deferred;
+        state->deferred_capacity = capacity;
+    }
+
+    deferred_draw_t *draw = &state->deferred[state->deferred_count++];
+    draw->chunk           = chunk;
+    draw->min             = min;
+    draw->max             = max;
+    draw->range_count     = range_count;
+    draw->hidden          = chunk->occluded;
+    draw->query           = !chunk->occlusion_pending;
+    memcpy(draw->ranges, ranges, range_count * sizeof(renderer_index_range_t));
+    return draw->hidden;
+}
+
+// Queries the bounds of the deferred chunks against the depth of the chunks drawn so far, then draws the hidden ones
+// only if their query passed. The GPU resolves the queries, the results are read back in a later frame. A query is
+// never reissued before its result was read back, otherwise a GPU running a few frames behind would never report it
+// and hidden chunks would stay hidden for good.
+static void draw_deferred_chunks(world_renderer_state_t *state) {
+    if (state->deferred_count == 0) {
+        return;
+    }
+
+    renderer_begin_occlusion_pass();
+    for (size_t i = 0; i < state->deferred_count; ++i) {
+        deferred_draw_t *draw = &state->deferred[i];
+        if (!draw->query) {
+            continue;
+        }
+
+        if (draw->chunk->occlusion_query == 0) {
+            draw->chunk->occlusion_query = occlusion_query_create();
+        }
+
+        vec3s min  = glms_vec3_subs(draw->min, OCCLUSION_BOUNDS_PADDING);
+        vec3s size = glms_vec3_adds(glms_vec3_sub(draw->max, draw->min), OCCLUSION_BOUNDS_PADDING * 2.0f);
+        occlusion_query_begin(draw->chunk->occlusion_query);
+        renderer_draw_mesh(state->bounds_mesh, min, GLMS_VEC3_ZERO, size);
+        occlusion_query_end();
+        draw->chunk->occlusion_pending = 1;
+    }
+    renderer_end_occlusion_pass();
+
+    for (size_t i = 0; i < state->deferred_count; ++i) {
+        deferred_draw_t *draw = &state->deferred[i];
+        if (!draw->hidden) {
+            continue;
+        }
+
+        batch_chunk_ranges(&state->conditional_batch, draw->chunk, draw->ranges, draw->range_count);
+        occlusion_query_begin_conditional(draw->chunk->occlusion_query);
+        renderer_draw_pool_batch(state->chunk_pool, state->block_shader, state->tilemap->texture,
+                                 &state->conditional_batch);
+        occlusion_query_end_conditional();
+    }
+    state->deferred_count = 0;
+}
+
+void world_renderer_render(world_renderer_t *renderer, world_t *world, camera_t *camera) {
+    if (renderer == NULL) {
+        LOG_ERROR("'world_renderer_render' called with NULL renderer");
+        return;
+    }
+
+    if (world == NULL) {
+        LOG_ERROR("'world_renderer_render' called with NULL world");
+        return;
+    }
+
+    if (camera == NULL) {
+        LOG_ERROR("'world_renderer_render' called with NULL camera");
+        return;
+    }
+
+    world_renderer_state_t *state = renderer->state;
+    vec3s camera_position         = camera_get_position(camera);
+
+    state->camera_chunk = (ivec2s) {{(int)floorf(camera_position.x / CHUNK_SIZE),
+                                     (int)floorf(camera_position.z / CHUNK_SIZE)}};
+    state->has_camera   = 1;
+
+    // Skip the sections hidden behind solid ground, then cull whole columns and only then the sections of the columns
+    // that passed
+    ++state->frame;
+    state->visibility_searched = find_visible_sections(state, world, camera_position) == 0;
+
+    frustum_t frustum = camera_get_frustum(camera);
+    collect_candidates(state, world, camera_position);
+    frustum_cull_aabbs(&frustum, &state->chunk_bounds);
+
+    // Every drawable section of the visible columns pushes exactly one box, the walk below relies on it. If a push
+    // fails, the sections are drawn without culling them one by one this frame.
+    aabb_list_t *sections = &state->section_bounds;
+    int cull_sections     = 1;
+    for (size_t i = 0; i < state->chunk_bounds.count && cull_sections; ++i) {
+        chunk_t *chunk = state->candidates[i];
+        if (!state->chunk_bounds.visible[i]) {
+            continue;
+        }
+
+        for (int s = 0; s < CHUNK_SECTION_COUNT; ++s) {
+            if (!section_drawable(state, &chunk->sections[s])) {
+                continue;
+            }
+
+            vec3s min = {{chunk->position.x * CHUNK_SIZE, s * CHUNK_SECTION_HEIGHT, chunk->position.y * CHUNK_SIZE}};
+            vec3s max = {{min.x + CHUNK_SIZE, min.y + CHUNK_SECTION_HEIGHT, min.z + CHUNK_SIZE}};
+            if (aabb_list_push(sections, min, max) != 0) {
+                cull_sections = 0;
+                break;
+            }
+        }
+    }
+    if (cull_sections) {
+        frustum_cull_aabbs(&frustum, sections);
+    }
+
+    // Walk the sections in the order they were pushed, merging neighboring visible sections into a single draw. The
+    // degenerate padding between their slots draws nothing.
+    int queries   = state->bounds_mesh != NULL && renderer_get_state()->occlusion_queries;
+    size_t cursor = 0;
+    for (size_t i = 0; i < state->chunk_bounds.count; ++i) {
+        chunk_t *chunk = state->candidates[i];
+        if (!state->chunk_bounds.visible[i]) {
+            continue;
+        }
+
+        renderer_index_range_t ranges[CHUNK_SECTION_COUNT];
+        size_t range_count = 0;
+        int previous       = -2;
+        for (int s = 0; s < CHUNK_SECTION_COUNT; ++s) {
+            chunk_section_t *section = &chunk->sections[s];
+            if (!section_drawable(state, section) || (cull_sections && !sections->visible[cursor++])) {
+                continue;
+            }
+
+            if (previous == s - 1) {
+                renderer_index_range_t *range = &ranges[range_count - 1];
+                range->count                  = section->index_offset + section->index_count - range->first;
+            } else {
+                ranges[range_count++] = (renderer_index_range_t) {section->index_offset, section->index_count};
+            }
+            previous = s;
+        }
+
+        if (range_count == 0) {
+            continue;
+        }
+
+        vec3s min = {{state->chunk_bounds.min_x[i], state->chunk_bounds.min_y[i], state->chunk_bounds.min_z[i]}};
+        vec3s max = {{state->chunk_bounds.max_x[i], state->chunk_bounds.max_y[i], state->chunk_bounds.max_z[i]}};
+        if (queries && defer_chunk_draw(state, chunk, min, max, camera_position, ranges, range_count)) {
+            continue;
+        }
+
+        batch_chunk_ranges(&state->chunk_batch, chunk, ranges, range_count);
+    }
+
+    // Every visible chunk goes out in a single call, before the queries that test against their depth
+    renderer_draw_pool_batch(state->chunk_pool, state->block_shader, state->tilemap->texture, &state->chunk_batch);
+
+    if (queries) {
+        draw_deferred_chunks(state);
+    }
+}
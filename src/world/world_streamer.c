@@ -0,0 +1,219 @@
+#include "world/world_streamer.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "core/log.h"
+
+// Chunks that are still being meshed and refused to unload, retried on the next update
+#define UNLOAD_RETRY_LIMIT 64
+
+typedef struct {
+    ivec2s position;
+    int distance;
+} stream_entry_t;
+
+struct world_streamer {
+    world_streamer_settings_t settings;
+
+    // Offsets within the load radius, sorted nearest first and by angle within a ring
+    ivec2s *offsets;
+    size_t offset_count;
+
+    // Index of the first offset that may still be missing around the current center
+    size_t load_cursor;
+
+    // Max heap of chunks to unload, keyed by squared distance to the center
+    stream_entry_t *unloads;
+    size_t unload_count;
+    size_t unload_capacity;
+
+    ivec2s center;
+    int has_center;
+};
+
+static int squared_distance(ivec2s a, ivec2s b) {
+    int dx = a.x - b.x;
+    int dz = a.y - b.y;
+    return dx * dx + dz * dz;
+}
+
+static int compare_offsets(const void *a, const void *b) {
+    const ivec2s *first  = a;
+    const ivec2s *second = b;
+
+    int first_distance  = first->x * first->x + first->y * first->y;
+    int second_distance = second->x * second->x + second->y * second->y;
+    if (first_distance != second_distance) {
+        return first_distance - second_distance;
+    }
+
+    double first_angle  = atan2(first->y, first->x);
+    double second_angle = atan2(second->y, second->x);
+    return (first_angle > second_angle) - (first_angle < second_angle);
+}
+
+static void unload_push(world_streamer_t *streamer, stream_entry_t entry) {
+    if (streamer->unload_count == streamer->unload_capacity) {
+        size_t capacity         = streamer->unload_capacity ? streamer->unload_capacity * 2 : 64;
+        stream_entry_t *entries = realloc(streamer->unloads, capacity * sizeof(stream_entry_t));
+        if (entries == NULL) {
+            LOG_ERROR("Failed to grow the chunk unload queue");
+            return;
+        }
+        streamer->unloads         = entries;
+        streamer->unload_capacity = capacity;
+    }
+
+    size_t index = streamer->unload_count++;
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (streamer->unloads[parent].distance >= entry.distance) {
+            break;
+        }
+        streamer->unloads[index] = streamer->unloads[parent];
+        index                    = parent;
+    }
+    streamer->unloads[index] = entry;
+}
+
+static stream_entry_t unload_pop(world_streamer_t *streamer) {
+    stream_entry_t top  = streamer->unloads[0];
+    stream_entry_t last = streamer->unloads[--streamer->unload_count];
+
+    size_t index = 0;
+    for (;;) {
+        size_t child = index * 2 + 1;
+        if (child >= streamer->unload_count) {
+            break;
+        }
+        if (child + 1 < streamer->unload_count &&
+            streamer->unloads[child + 1].distance > streamer->unloads[child].distance) {
+            ++child;
+        }
+        if (last.distance >= streamer->unloads[child].distance) {
+            break;
+        }
+        streamer->unloads[index] = streamer->unloads[child];
+        index                    = child;
+    }
+
+    if (streamer->unload_count > 0) {
+        streamer->unloads[index] = last;
+    }
+    return top;
+}
+
+world_streamer_t *world_streamer_create(world_streamer_settings_t settings) {
+    if (settings.unload_radius <= settings.load_radius) {
+        LOG_WARN("Unload radius %d is not larger than load radius %d", settings.unload_radius, settings.load_radius);
+        settings.unload_radius = settings.load_radius + 1;
+    }
+
+    world_streamer_t *streamer = calloc(1, sizeof(world_streamer_t));
+    if (streamer == NULL) {
+        LOG_ERROR("Failed to allocate world streamer");
+        return NULL;
+    }
+    streamer->settings = settings;
+
+    int radius        = settings.load_radius;
+    streamer->offsets = malloc((2 * radius + 1) * (2 * radius + 1) * sizeof(ivec2s));
+    if (streamer->offsets == NULL) {
+        LOG_ERROR("Failed to allocate world streamer offsets");
+        free(streamer);
+        return NULL;
+    }
+
+    for (int z = -radius; z <= radius; ++z) {
+        for (int x = -radius; x <= radius; ++x) {
+            if (x * x + z * z <= radius * radius) {
+                streamer->offsets[streamer->offset_count++] = (ivec2s) {{x, z}};
+            }
+        }
+    }
+    qsort(streamer->offsets, streamer->offset_count, sizeof(ivec2s), compare_offsets);
+
+    return streamer;
+}
+
+void world_streamer_destroy(world_streamer_t *streamer) {
+    if (streamer == NULL) {
+        LOG_ERROR("'world_streamer_destroy' called with NULL streamer");
+        return;
+    }
+
+    free(streamer->offsets);
+    free(streamer->unloads);
+    free(streamer);
+}
+
+int world_streamer_update(world_streamer_t *streamer, world_t *world, ivec2s center) {
+    if (streamer == NULL) {
+        LOG_ERROR("'world_streamer_update' called with NULL streamer");
+        return 0;
+    }
+
+    if (world == NULL) {
+        LOG_ERROR("'world_streamer_update' called with NULL world");
+        return 0;
+    }
+
+    int unload_distance = streamer->settings.unload_radius * streamer->settings.unload_radius;
+
+    // A new center restarts the spiral and collects the chunks that fell out of range
+    if (!streamer->has_center || center.x != streamer->center.x || center.y != streamer->center.y) {
+        streamer->center       = center;
+        streamer->has_center   = 1;
+        streamer->load_cursor  = 0;
+        streamer->unload_count = 0;
+
+        for (size_t i = 0; i < world->chunk_count; ++i) {
+            ivec2s position = world->chunks[i]->position;
+            int distance    = squared_distance(position, center);
+            if (distance > unload_distance) {
+                unload_push(streamer, (stream_entry_t) {position, distance});
+            }
+        }
+    }
+
+    // Unload farthest first. Chunks still being meshed are retried on a later update.
+    stream_entry_t deferred[UNLOAD_RETRY_LIMIT];
+    int deferred_count = 0;
+    int unloaded       = 0;
+    while (streamer->unload_count > 0 && unloaded < streamer->settings.unloads_per_update &&
+           deferred_count < UNLOAD_RETRY_LIMIT) {
+        stream_entry_t entry = unload_pop(streamer);
+        chunk_t *chunk       = world_get_chunk(world, entry.position.x, entry.position.y);
+        if (chunk == NULL) {
+            continue;
+        }
+
+        if (world_unload_chunk(world, chunk) == 0) {
+            ++unloaded;
+        } else {
+            deferred[deferred_count++] = entry;
+        }
+    }
+    for (int i = 0; i < deferred_count; ++i) {
+        unload_push(streamer, deferred[i]);
+    }
+
+    // Load nearest first, skipping over the chunks that are already resident
+    int loaded = 0;
+    for (; streamer->load_cursor < streamer->offset_count && loaded < streamer->settings.loads_per_update;
+         ++streamer->load_cursor) {
+        ivec2s offset   = streamer->offsets[streamer->load_cursor];
+        ivec2s position = (ivec2s) {{center.x + offset.x, center.y + offset.y}};
+        if (world_get_chunk(world, position.x, position.y)) {
+            continue;
+        }
+
+        if (world_load_chunk(world, position) == NULL) {
+            break;
+        }
+        ++loaded;
+    }
+
+    return loaded + unloaded;
+}